@@ -0,0 +1,40 @@
+#pragma once
+
+// C++ Includes
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+namespace quick::bench
+{
+
+/// @brief The mutex + condition_variable + std::queue design ThreadSafeQueue
+/// used to have, kept as a baseline for the queue benchmarks.
+template <typename T> class LockingQueue
+{
+    std::queue<T> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+
+  public:
+    void push(T value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push(std::move(value));
+        }
+        m_cv.notify_one();
+    }
+
+    T wait_and_pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [&] { return !m_queue.empty(); });
+        T val = std::move(m_queue.front());
+        m_queue.pop();
+        return val;
+    }
+};
+
+} // End namespace quick::bench
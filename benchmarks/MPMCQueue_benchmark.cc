@@ -0,0 +1,92 @@
+// C++ Includes
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "LockingQueue.hh"
+#include "quick/structs/MPMCQueue.hh"
+#include "quick/structs/ThreadSafeQueue.hh"
+
+namespace
+{
+constexpr std::int64_t kItemsPerProducer = 100'000;
+
+// Arg(0) producers and Arg(0) consumers move kItemsPerProducer each through
+// one queue. A failed push/pop yields, so oversubscribed runs (more threads
+// than cores) still finish.
+void BM_MPMC_Contention(benchmark::State &state)
+{
+    const auto pairs = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        auto queue = std::make_unique<quick::structs::MPMCQueue<std::int64_t, 1024>>();
+        std::vector<std::jthread> threads;
+        for (std::size_t p = 0; p < pairs; ++p)
+            threads.emplace_back([&] {
+                for (std::int64_t i = 0; i < kItemsPerProducer; ++i)
+                    while (!queue->push(i))
+                        std::this_thread::yield();
+            });
+        for (std::size_t c = 0; c < pairs; ++c)
+            threads.emplace_back([&] {
+                std::int64_t value = 0;
+                for (std::int64_t received = 0; received < kItemsPerProducer;)
+                {
+                    if (queue->pop(value))
+                        ++received;
+                    else
+                        std::this_thread::yield();
+                }
+                benchmark::DoNotOptimize(value);
+            });
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pairs) * kItemsPerProducer);
+}
+
+// Same traffic through a blocking queue: the old mutex design or the
+// lock-free ThreadSafeQueue
+template <class Queue> void BM_Blocking_Contention(benchmark::State &state)
+{
+    const auto pairs = static_cast<std::size_t>(state.range(0));
+    // Built once: every iteration drains it, and the 1 << 17 ring is 8 MiB
+    // we don't want to time allocating and faulting in
+    auto queue = std::make_unique<Queue>();
+    for (auto _ : state)
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t p = 0; p < pairs; ++p)
+            threads.emplace_back([&] {
+                for (std::int64_t i = 0; i < kItemsPerProducer; ++i)
+                    queue->push(i);
+            });
+        for (std::size_t c = 0; c < pairs; ++c)
+            threads.emplace_back([&] {
+                for (std::int64_t received = 0; received < kItemsPerProducer; ++received)
+                    benchmark::DoNotOptimize(queue->wait_and_pop());
+            });
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(pairs) * kItemsPerProducer);
+}
+
+// 1, 2, 4, ... producer/consumer pairs up to one thread per core (at least 4)
+void ContentionArgs(benchmark::internal::Benchmark *bench)
+{
+    const std::int64_t max_pairs = std::max<std::int64_t>(4, std::thread::hardware_concurrency() / 2);
+    bench->ArgName("pairs");
+    for (std::int64_t pairs = 1; pairs <= max_pairs; pairs *= 2)
+        bench->Arg(pairs);
+    bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+} // namespace
+
+BENCHMARK(BM_MPMC_Contention)->Apply(ContentionArgs);
+BENCHMARK(BM_Blocking_Contention<quick::bench::LockingQueue<std::int64_t>>)->Apply(ContentionArgs);
+BENCHMARK(BM_Blocking_Contention<quick::structs::ThreadSafeQueue<std::int64_t>>)->Apply(ContentionArgs);
+// Ring that holds one producer's whole run, so a single pair never blocks on a
+// full ring (closer to the unbounded LockingQueue); more pairs still can
+BENCHMARK(BM_Blocking_Contention<quick::structs::ThreadSafeQueue<std::int64_t, 1 << 17>>)->Apply(ContentionArgs);
@@ -0,0 +1,66 @@
+#pragma once
+
+// C++ Includes
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace quick::bench
+{
+
+/// @brief The single std::queue + mutex + counting_semaphore design
+/// ThreadPool used to have, kept as a baseline for the pool benchmarks.
+class MutexThreadPool
+{
+    std::queue<std::move_only_function<void()>> m_tasks;
+    std::vector<std::jthread> m_workers;
+    std::mutex m_mutex;
+    std::counting_semaphore<> m_semaphore{0};
+
+  public:
+    explicit MutexThreadPool(std::size_t num_threads)
+    {
+        for (std::size_t i = 0; i < num_threads; ++i)
+            m_workers.emplace_back([this] {
+                for (;;)
+                {
+                    m_semaphore.acquire();
+                    std::move_only_function<void()> task;
+                    {
+                        std::scoped_lock lock(m_mutex);
+                        if (m_tasks.empty())
+                            return;
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop();
+                    }
+                    task();
+                }
+            });
+    }
+
+    // One extra release per worker: each exits once it finds the queue empty
+    ~MutexThreadPool()
+    {
+        m_semaphore.release(static_cast<std::ptrdiff_t>(m_workers.size()));
+    }
+
+    template <class F, class... Args>
+    auto enqueue(F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>
+    {
+        using Ret = std::invoke_result_t<F, Args...>;
+        auto task = std::packaged_task<Ret()>(std::bind_front(std::forward<F>(f), std::forward<Args>(args)...));
+        auto fut = task.get_future();
+        {
+            std::scoped_lock lock(m_mutex);
+            m_tasks.emplace(std::move(task));
+        }
+        m_semaphore.release();
+        return fut;
+    }
+};
+
+} // End namespace quick::bench
@@ -0,0 +1,147 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// QuickLib Includes
+#include "quick/structs/Orderbook.hh"
+#include "quick/utils/XorBitant.hh"
+
+namespace quick::bench
+{
+
+/// @brief Shape of the synthetic order flow.
+struct FlowConfig
+{
+    Price mid{10'000};
+    Price depth{100};           ///< Passive orders land 1..depth ticks away from the mid
+    double cross_rate{0.1};     ///< Fraction of adds priced through the opposite side
+    double cancel_ratio{0.3};   ///< Fraction of messages that cancel a resting order
+    Quantity max_qty{10};       ///< Order sizes are uniform in [1, max_qty]
+    std::uint64_t seed{0x5EED};
+};
+
+/// @brief Deterministic add/cancel stream for replaying into any
+/// `OrderbookEngine`.
+/// `warmup()` rests one order on every level of both sides so the book
+/// starts at the configured depth; `generate()` then mixes passive adds,
+/// marketable adds and cancels of orders the generator itself rested.
+/// Cancels may target an order that has since been filled, the same as in
+/// real flow.
+class OrderFlow
+{
+    FlowConfig m_config;
+    XorBitant m_rng;
+    Id m_next_id{1};
+    std::vector<Id> m_resting; // ids of passive adds, candidates for cancels
+
+    bool chance(double p) noexcept
+    {
+        return static_cast<double>(m_rng()) < p * static_cast<double>(XorBitant::max());
+    }
+
+    Quantity qty() noexcept
+    {
+        return static_cast<Quantity>(1 + m_rng() % static_cast<std::uint32_t>(m_config.max_qty));
+    }
+
+    OrderCommand passive(bool is_buy, Price distance)
+    {
+        const Price level = is_buy ? m_config.mid - distance : m_config.mid + distance;
+        const Id id = m_next_id++;
+        m_resting.push_back(id);
+        return OrderCommand::add(Order{id, level, is_buy, qty()});
+    }
+
+  public:
+    explicit OrderFlow(const FlowConfig &config) : m_config{config}, m_rng{config.seed}
+    {
+    }
+
+    const FlowConfig &config() const noexcept
+    {
+        return m_config;
+    }
+
+    /// @brief One passive order per level per side.
+    std::vector<OrderCommand> warmup()
+    {
+        std::vector<OrderCommand> commands;
+        commands.reserve(2 * static_cast<std::size_t>(m_config.depth));
+        for (Price distance = 1; distance <= m_config.depth; ++distance)
+        {
+            commands.push_back(passive(true, distance));
+            commands.push_back(passive(false, distance));
+        }
+        return commands;
+    }
+
+    /// @brief Next `count` messages of the stream.
+    std::vector<OrderCommand> generate(std::size_t count)
+    {
+        std::vector<OrderCommand> commands;
+        commands.reserve(count);
+        while (commands.size() < count)
+        {
+            if (!m_resting.empty() && chance(m_config.cancel_ratio))
+            {
+                // Swap-remove a random resting id
+                const std::size_t victim = m_rng() % m_resting.size();
+                commands.push_back(OrderCommand::cancel(m_resting[victim]));
+                m_resting[victim] = m_resting.back();
+                m_resting.pop_back();
+                continue;
+            }
+
+            const bool is_buy = (m_rng() & 1U) != 0;
+            if (chance(m_config.cross_rate))
+            {
+                // Priced at the far edge of the opposite side: sweeps whatever is there
+                const Price level = is_buy ? m_config.mid + m_config.depth : m_config.mid - m_config.depth;
+                commands.push_back(OrderCommand::add(Order{m_next_id++, level, is_buy, qty()}));
+                continue;
+            }
+            commands.push_back(passive(is_buy, static_cast<Price>(1 + m_rng() % static_cast<std::uint32_t>(m_config.depth))));
+        }
+        return commands;
+    }
+};
+
+/// @brief Per-message latency samples in nanoseconds, preallocated so
+/// recording never allocates inside a timed region.
+class LatencySamples
+{
+    std::vector<std::uint64_t> m_samples;
+
+  public:
+    explicit LatencySamples(std::size_t expected)
+    {
+        m_samples.reserve(expected);
+    }
+
+    void record(std::uint64_t ns)
+    {
+        m_samples.push_back(ns);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_samples.size();
+    }
+
+    /// @param q Quantile in [0, 1]
+    /// @return The sample at that quantile, 0 if nothing was recorded
+    /// @note Partially reorders the samples
+    double quantile(double q)
+    {
+        if (m_samples.empty())
+            return 0.0;
+        const auto rank = static_cast<std::size_t>(q * static_cast<double>(m_samples.size() - 1));
+        std::nth_element(m_samples.begin(), m_samples.begin() + static_cast<std::ptrdiff_t>(rank), m_samples.end());
+        return static_cast<double>(m_samples[rank]);
+    }
+};
+
+} // End namespace quick::bench
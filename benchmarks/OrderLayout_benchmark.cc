@@ -0,0 +1,172 @@
+// C++ Includes
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "bench_utils.hh"
+#include "quick/structs/LadderOrderbook.hh"
+#include "quick/structs/Orderbook.hh"
+#include "quick/utils/XorBitant.hh"
+
+// Cache misses per fill: the pre-packing `Order` layout (32 bytes, bool + redundant Side) stored as an intrusive
+// array-of-structs node, against the 16-byte hot half of the ladder book's structure-of-arrays store.
+namespace
+{
+using Handle = std::uint32_t;
+constexpr Handle kNull = ~Handle{0};
+
+struct LegacyOrder
+{
+    Id id;
+    Price level;
+    bool is_buy;
+    Quantity qty;
+    Order::Side side;
+};
+
+struct LegacyNode
+{
+    LegacyOrder order;
+    Handle prev;
+    Handle next;
+};
+
+struct HotNode
+{
+    Id id;
+    Quantity qty;
+    Handle next;
+};
+
+struct ColdNode
+{
+    Price level;
+    Handle prev;
+    bool is_buy;
+};
+
+// A level's FIFO scattered across a pool that has seen plenty of churn
+std::vector<Handle> scattered_order(std::size_t n)
+{
+    std::vector<Handle> order(n);
+    std::iota(order.begin(), order.end(), Handle{0});
+    std::shuffle(order.begin(), order.end(), XorBitant{});
+    return order;
+}
+
+void report(benchmark::State &state, quick::bench::PerfCounter &l1d, quick::bench::PerfCounter &llc,
+            std::uint64_t l1d_misses, std::uint64_t llc_misses, std::uint64_t fills)
+{
+    state.SetItemsProcessed(static_cast<std::int64_t>(fills));
+    if (!l1d.valid() || !llc.valid())
+    {
+        state.SetLabel("perf counters unavailable");
+        return;
+    }
+    state.counters["l1d_misses/fill"] = static_cast<double>(l1d_misses) / static_cast<double>(fills);
+    state.counters["llc_misses/fill"] = static_cast<double>(llc_misses) / static_cast<double>(fills);
+}
+
+void BM_LevelWalk_LegacyAoS(benchmark::State &state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const auto links = scattered_order(n);
+    std::vector<LegacyNode> pool(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        pool[links[i]] = LegacyNode{LegacyOrder{i, 100, false, 1, Order::Side::SELL}, i ? links[i - 1] : kNull,
+                                    i + 1 < n ? links[i + 1] : kNull};
+    }
+
+    quick::bench::PerfCounter l1d{PERF_TYPE_HW_CACHE, quick::bench::PerfCounter::kL1dReadMisses};
+    quick::bench::PerfCounter llc{PERF_TYPE_HARDWARE, quick::bench::PerfCounter::kCacheMisses};
+    std::uint64_t l1d_misses = 0, llc_misses = 0, fills = 0;
+    for (auto _ : state)
+    {
+        l1d.start();
+        llc.start();
+        Id traded = 0;
+        for (Handle h = links.front(); h != kNull; h = pool[h].next)
+        {
+            traded += pool[h].order.id;
+            pool[h].order.qty ^= 1; // stands in for the fill
+        }
+        l1d_misses += l1d.stop();
+        llc_misses += llc.stop();
+        fills += n;
+        benchmark::DoNotOptimize(traded);
+    }
+    report(state, l1d, llc, l1d_misses, llc_misses, fills);
+}
+
+void BM_LevelWalk_HotSoA(benchmark::State &state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const auto links = scattered_order(n);
+    std::vector<HotNode> hot(n);
+    std::vector<ColdNode> cold(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        hot[links[i]] = HotNode{i, 1, i + 1 < n ? links[i + 1] : kNull};
+        cold[links[i]] = ColdNode{100, i ? links[i - 1] : kNull, false};
+    }
+
+    quick::bench::PerfCounter l1d{PERF_TYPE_HW_CACHE, quick::bench::PerfCounter::kL1dReadMisses};
+    quick::bench::PerfCounter llc{PERF_TYPE_HARDWARE, quick::bench::PerfCounter::kCacheMisses};
+    std::uint64_t l1d_misses = 0, llc_misses = 0, fills = 0;
+    for (auto _ : state)
+    {
+        l1d.start();
+        llc.start();
+        Id traded = 0;
+        for (Handle h = links.front(); h != kNull; h = hot[h].next)
+        {
+            traded += hot[h].id;
+            hot[h].qty ^= 1;
+        }
+        l1d_misses += l1d.stop();
+        llc_misses += llc.stop();
+        fills += n;
+        benchmark::DoNotOptimize(traded);
+    }
+    report(state, l1d, llc, l1d_misses, llc_misses, fills);
+}
+
+// End to end: one aggressive order sweeps a single level of `n` one-lot orders
+template <class Book> void BM_LevelSweep(benchmark::State &state)
+{
+    const auto n = static_cast<Id>(state.range(0));
+    Book book;
+    Id id = 1;
+    std::vector<Trade> storage(n);
+    TradeBuffer buffer{storage};
+
+    quick::bench::PerfCounter l1d{PERF_TYPE_HW_CACHE, quick::bench::PerfCounter::kL1dReadMisses};
+    quick::bench::PerfCounter llc{PERF_TYPE_HARDWARE, quick::bench::PerfCounter::kCacheMisses};
+    std::uint64_t l1d_misses = 0, llc_misses = 0, fills = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (Id i = 0; i < n; ++i)
+            (void)book.AddOrder(Order{id++, 100, false, 1}, buffer);
+        buffer.clear();
+        state.ResumeTiming();
+
+        l1d.start();
+        llc.start();
+        fills += book.AddOrder(Order{id++, 100, true, static_cast<Quantity>(n)}, buffer);
+        l1d_misses += l1d.stop();
+        llc_misses += llc.stop();
+    }
+    report(state, l1d, llc, l1d_misses, llc_misses, fills);
+}
+} // namespace
+
+BENCHMARK(BM_LevelWalk_LegacyAoS)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_LevelWalk_HotSoA)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_LevelSweep<Orderbook>)->Arg(1 << 10)->Arg(1 << 14);
+BENCHMARK(BM_LevelSweep<LadderOrderbook>)->Arg(1 << 10)->Arg(1 << 14);
@@ -0,0 +1,96 @@
+// C++ Includes
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "OrderFlow.hh"
+#include "quick/structs/LadderOrderbook.hh"
+#include "quick/structs/Orderbook.hh"
+
+namespace
+{
+constexpr std::size_t kStreamLength = 1UL << 16;
+
+template <class Book> std::unique_ptr<Book> make_book()
+{
+    if constexpr (std::is_same_v<Book, LadderOrderbook>)
+        // Room for every passive add of a cancel-free stream
+        return std::make_unique<Book>(0, LadderOrderbook::default_max_price_, 1U << 17);
+    else
+        return std::make_unique<Book>();
+}
+
+// Replays the same synthetic stream into a fresh (pre-warmed) book each
+// iteration and times every message individually. Rebuilding the book is
+// excluded from the timing, so msgs/sec covers matching work only (plus one
+// clock read per message, ~20ns, which also inflates the percentiles).
+// Args: book depth in ticks, cross rate in %, cancel ratio in %.
+template <class Book> void BM_Replay(benchmark::State &state)
+{
+    quick::bench::FlowConfig config;
+    config.depth = static_cast<Price>(state.range(0));
+    config.cross_rate = static_cast<double>(state.range(1)) / 100.0;
+    config.cancel_ratio = static_cast<double>(state.range(2)) / 100.0;
+
+    quick::bench::OrderFlow flow{config};
+    const std::vector<OrderCommand> warmup = flow.warmup();
+    const std::vector<OrderCommand> stream = flow.generate(kStreamLength);
+
+    std::array<Trade, 1024> storage{};
+    TradeBuffer buffer{storage};
+    quick::bench::LatencySamples add_ns{kStreamLength * 4};
+    quick::bench::LatencySamples cancel_ns{kStreamLength * 4};
+    std::int64_t trades = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto book = make_book<Book>();
+        for (const OrderCommand &command : warmup)
+            ApplyCommand(*book, command, buffer);
+        buffer.clear();
+        state.ResumeTiming();
+
+        for (const OrderCommand &command : stream)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            trades += static_cast<std::int64_t>(ApplyCommand(*book, command, buffer));
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            const auto ns = static_cast<std::uint64_t>(std::chrono::nanoseconds{elapsed}.count());
+            (command.type == OrderCommand::Type::CANCEL ? cancel_ns : add_ns).record(ns);
+            buffer.clear();
+        }
+        benchmark::DoNotOptimize(book->best_bid());
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(stream.size()));
+    state.counters["trades/msg"] =
+        static_cast<double>(trades) / static_cast<double>(state.iterations() * static_cast<std::int64_t>(stream.size()));
+    state.counters["add_p50_ns"] = add_ns.quantile(0.50);
+    state.counters["add_p99_ns"] = add_ns.quantile(0.99);
+    state.counters["add_p999_ns"] = add_ns.quantile(0.999);
+    state.counters["cancel_p50_ns"] = cancel_ns.quantile(0.50);
+    state.counters["cancel_p99_ns"] = cancel_ns.quantile(0.99);
+    state.counters["cancel_p999_ns"] = cancel_ns.quantile(0.999);
+}
+
+void ReplayArgs(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames({"depth", "cross%", "cancel%"});
+    for (std::int64_t depth : {10, 500})
+        for (std::int64_t cross : {5, 30})
+            for (std::int64_t cancel : {0, 30, 60})
+                bench->Args({depth, cross, cancel});
+    // Bounded number of iterations keeps the sample buffers within their reservation
+    bench->Iterations(4);
+}
+} // namespace
+
+BENCHMARK(BM_Replay<Orderbook>)->Apply(ReplayArgs);
+BENCHMARK(BM_Replay<LadderOrderbook>)->Apply(ReplayArgs);
@@ -0,0 +1,76 @@
+// C++ Includes
+#include <array>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "bench_utils.hh"
+#include "quick/structs/LadderOrderbook.hh"
+#include "quick/structs/Orderbook.hh"
+
+namespace
+{
+constexpr Price kMidPrice = 10'000;
+
+// Rests `depth` one-lot orders per side, one per tick away from the mid, and
+// hands back the next free order id
+template <class Book> Id prefill(Book &book, std::int64_t depth)
+{
+    Id id = 1;
+    for (std::int64_t i = 1; i <= depth; ++i)
+    {
+        (void)book.AddOrder(Order{id++, kMidPrice - i, true, 1});
+        (void)book.AddOrder(Order{id++, kMidPrice + i, false, 1});
+    }
+    return id;
+}
+
+// Steady state: every iteration lifts the best ask and replenishes it, so the
+// book keeps its shape and the only work is one fill plus one insert.
+template <class Book> void BM_AddOrder_ReturnTrades(benchmark::State &state)
+{
+    Book book;
+    Id id = prefill(book, state.range(0));
+    std::int64_t trades = 0;
+
+    const auto allocs_before = quick::bench::allocation_count();
+    for (auto _ : state)
+    {
+        Trades fills = book.AddOrder(Order{id++, kMidPrice + 1, true, 1});
+        trades += static_cast<std::int64_t>(fills.size());
+        benchmark::DoNotOptimize(book.AddOrder(Order{id++, kMidPrice + 1, false, 1}));
+    }
+    const auto allocs = quick::bench::allocation_count() - allocs_before;
+
+    state.counters["trades"] = benchmark::Counter(static_cast<double>(trades), benchmark::Counter::kAvgIterations);
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+}
+
+template <class Book> void BM_AddOrder_TradeBuffer(benchmark::State &state)
+{
+    Book book;
+    Id id = prefill(book, state.range(0));
+    std::array<Trade, 64> storage{};
+    TradeBuffer buffer{storage};
+    std::int64_t trades = 0;
+
+    const auto allocs_before = quick::bench::allocation_count();
+    for (auto _ : state)
+    {
+        buffer.clear();
+        trades += static_cast<std::int64_t>(book.AddOrder(Order{id++, kMidPrice + 1, true, 1}, buffer));
+        trades += static_cast<std::int64_t>(book.AddOrder(Order{id++, kMidPrice + 1, false, 1}, buffer));
+        benchmark::DoNotOptimize(buffer);
+    }
+    const auto allocs = quick::bench::allocation_count() - allocs_before;
+
+    state.counters["trades"] = benchmark::Counter(static_cast<double>(trades), benchmark::Counter::kAvgIterations);
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+}
+} // namespace
+
+BENCHMARK(BM_AddOrder_ReturnTrades<Orderbook>)->Arg(100)->Arg(5'000);
+BENCHMARK(BM_AddOrder_ReturnTrades<LadderOrderbook>)->Arg(100)->Arg(5'000);
+BENCHMARK(BM_AddOrder_TradeBuffer<Orderbook>)->Arg(100)->Arg(5'000);
+BENCHMARK(BM_AddOrder_TradeBuffer<LadderOrderbook>)->Arg(100)->Arg(5'000);
@@ -0,0 +1,199 @@
+// C Includes
+#include <pthread.h>
+#include <sched.h>
+
+// C++ Includes
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "bench_utils.hh"
+#include "quick/memory/HugePageRegion.hh"
+#include "quick/structs/SPSCQueue.hh"
+#include "quick/thread/Affinity.hpp"
+
+namespace
+{
+using quick::structs::cacheline_t;
+
+// Same workload as examples/spsc_queue_example.cc: 100k doubles through a
+// 1 KB queue
+using Element = double;
+constexpr std::uint64_t kCapacity = (1 << 10) / sizeof(Element);
+constexpr std::int64_t kItems = 100'000;
+
+// The queue protocol before cached indices: every push acquires m_tail and
+// every pop acquires m_head, pulling the other core's line each time
+template <class T, std::uint64_t Capacity> class UncachedSPSCQueue
+{
+    static constexpr std::uint64_t kMask = Capacity - 1;
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_head{0};
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_tail{0};
+    alignas(cacheline_t::value) T m_slots[Capacity]{};
+
+  public:
+    bool emplace(T value)
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+            return false;
+        m_slots[head & kMask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &out)
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_head.load(std::memory_order_acquire) == tail)
+            return false;
+        out = m_slots[tail & kMask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Producer on its own thread, consumer on the benchmark thread, pinned to
+// CPUs 0/1 (the benchmark thread gets its affinity back afterwards, so later
+// benchmarks aren't stuck on CPU 1). With a single CPU both sides yield
+// instead of spinning (and the run is labelled), so the numbers then mostly
+// measure the scheduler.
+template <class Queue> void BM_SPSC_Throughput(benchmark::State &state)
+{
+    const bool pin = std::thread::hardware_concurrency() >= 2;
+    cpu_set_t saved;
+    const bool restore = pin && ::pthread_getaffinity_np(::pthread_self(), sizeof(saved), &saved) == 0;
+    if (pin)
+        quick::thread::pin_thread(::pthread_self(), 1);
+    else
+        state.SetLabel("single CPU: yielding");
+    auto wait = [pin] {
+        if (!pin)
+            std::this_thread::yield();
+    };
+
+    for (auto _ : state)
+    {
+        auto queue = std::make_unique<Queue>();
+        std::jthread producer{[&] {
+            for (std::int64_t i = 0; i < kItems; ++i)
+                while (!queue->emplace(static_cast<Element>(i)))
+                    wait();
+        }};
+        if (pin)
+            quick::thread::pin_thread(producer.native_handle(), 0);
+
+        Element value{};
+        for (std::int64_t received = 0; received < kItems;)
+            if (queue->pop(value))
+                ++received;
+            else
+                wait();
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * kItems);
+    if (restore)
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(saved), &saved);
+}
+
+struct Tick
+{
+    std::uint64_t ts;
+    std::int64_t px;
+    std::uint32_t qty;
+    std::uint32_t instrument;
+};
+
+// Burst of Arg(0) ticks in and out on one thread, element by element, so the
+// cost is one release store (and one slot index) per tick
+void BM_SPSC_Burst_Single(benchmark::State &state)
+{
+    auto queue = std::make_unique<quick::structs::SPSCQueue<Tick, 1024>>();
+    std::vector<Tick> burst(static_cast<std::size_t>(state.range(0)));
+    Tick out{};
+    for (auto _ : state)
+    {
+        for (const Tick &tick : burst)
+            queue->push(tick);
+        while (queue->pop(out))
+            benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same burst through push_bulk/pop_bulk: two memcpys and one release store
+// per side
+void BM_SPSC_Burst_Bulk(benchmark::State &state)
+{
+    auto queue = std::make_unique<quick::structs::SPSCQueue<Tick, 1024>>();
+    std::vector<Tick> burst(static_cast<std::size_t>(state.range(0)));
+    std::vector<Tick> out(burst.size());
+    for (auto _ : state)
+    {
+        queue->push_bulk(burst);
+        benchmark::DoNotOptimize(queue->pop_bulk(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 64 MiB ring of u64 per iteration. Construction (mapping + prefault) is
+// untimed but its minor faults are reported; the timed part streams the
+// whole ring through push_bulk/pop_bulk, where TLB reach shows up.
+// Arg: quick::memory::HugePages
+void BM_SPSC_MappedRing(benchmark::State &state)
+{
+    using quick::memory::HugePages;
+    using quick::memory::PageBacking;
+    constexpr std::uint64_t kSlots = (64UL << 20) / sizeof(std::uint64_t);
+    const auto pages = static_cast<HugePages>(state.range(0));
+
+    std::vector<std::uint64_t> chunk(4096, 1);
+    quick::bench::PerfCounter tlb_misses{PERF_TYPE_HW_CACHE, quick::bench::PerfCounter::kDTLBReadMisses};
+    std::uint64_t faults = 0;
+    std::uint64_t misses = 0;
+    PageBacking backing = PageBacking::NORMAL;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        const std::uint64_t faults_before = quick::bench::minor_faults();
+        auto queue = std::make_unique<quick::structs::SPSCQueue<std::uint64_t, quick::structs::dynamic_capacity>>(
+            kSlots, pages);
+        faults += quick::bench::minor_faults() - faults_before;
+        backing = queue->page_backing();
+        state.ResumeTiming();
+
+        tlb_misses.start();
+        // Keep the ring nearly full so every access is a fresh page
+        for (std::uint64_t pushed = 0; pushed < kSlots; pushed += chunk.size())
+            queue->push_bulk(chunk);
+        for (std::uint64_t popped = 0; popped < kSlots; popped += chunk.size())
+            benchmark::DoNotOptimize(queue->pop_bulk(chunk));
+        misses += tlb_misses.stop();
+    }
+
+    constexpr const char *kBacking[] = {"4K pages", "THP", "hugetlb"};
+    state.SetLabel(kBacking[static_cast<int>(backing)]);
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(2 * kSlots * sizeof(std::uint64_t)));
+    state.counters["faults/ring"] = benchmark::Counter(static_cast<double>(faults), benchmark::Counter::kAvgIterations);
+    if (tlb_misses.valid())
+        state.counters["dTLB_misses/ring"] =
+            benchmark::Counter(static_cast<double>(misses), benchmark::Counter::kAvgIterations);
+}
+} // namespace
+
+BENCHMARK(BM_SPSC_Throughput<UncachedSPSCQueue<Element, kCapacity>>)->UseRealTime();
+BENCHMARK(BM_SPSC_Throughput<quick::structs::SPSCQueue<Element, kCapacity>>)->UseRealTime();
+BENCHMARK(BM_SPSC_Burst_Single)->Arg(16)->Arg(256);
+BENCHMARK(BM_SPSC_Burst_Bulk)->Arg(16)->Arg(256);
+BENCHMARK(BM_SPSC_MappedRing)
+    ->Arg(static_cast<int>(quick::memory::HugePages::NONE))
+    ->Arg(static_cast<int>(quick::memory::HugePages::TRANSPARENT))
+    ->Arg(static_cast<int>(quick::memory::HugePages::EXPLICIT))
+    ->Unit(benchmark::kMillisecond);
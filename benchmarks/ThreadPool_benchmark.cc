@@ -0,0 +1,211 @@
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "MutexThreadPool.hh"
+#include "bench_utils.hh"
+#include "quick/thread/ThreadPool.hpp"
+
+namespace
+{
+constexpr std::int64_t kFlatTasks = 20'000;
+constexpr int kTreeDepth = 14; // 2^15 - 1 tasks
+
+// A few hundred nanoseconds of work, so scheduling overhead dominates
+void tiny_work() noexcept
+{
+    std::uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 64; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 5;
+    }
+    benchmark::DoNotOptimize(x);
+}
+
+void wait_for(const std::atomic<std::int64_t> &done, std::int64_t target)
+{
+    while (done.load(std::memory_order_acquire) < target)
+        std::this_thread::yield();
+}
+
+// Independent tasks submitted from the benchmark thread
+template <class Pool> void BM_Pool_FlatTasks(benchmark::State &state)
+{
+    Pool pool(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        std::atomic<std::int64_t> done{0};
+        for (std::int64_t i = 0; i < kFlatTasks; ++i)
+            pool.enqueue([&done] {
+                tiny_work();
+                done.fetch_add(1, std::memory_order_release);
+            });
+        wait_for(done, kFlatTasks);
+    }
+    state.SetItemsProcessed(state.iterations() * kFlatTasks);
+}
+
+// Binary task tree: every task enqueues its two children from inside a
+// worker, the fork/join shape parallel algorithms produce
+template <class Pool> void BM_Pool_TaskTree(benchmark::State &state)
+{
+    Pool pool(static_cast<std::size_t>(state.range(0)));
+    constexpr std::int64_t kTasks = (std::int64_t{1} << (kTreeDepth + 1)) - 1;
+    for (auto _ : state)
+    {
+        std::atomic<std::int64_t> done{0};
+        auto spawn = [&pool, &done](auto &self, int depth) -> void {
+            tiny_work();
+            if (depth > 0)
+            {
+                pool.enqueue([&self, depth] { self(self, depth - 1); });
+                pool.enqueue([&self, depth] { self(self, depth - 1); });
+            }
+            done.fetch_add(1, std::memory_order_release);
+        };
+        pool.enqueue([&spawn] { spawn(spawn, kTreeDepth); });
+        wait_for(done, kTasks);
+    }
+    state.SetItemsProcessed(state.iterations() * kTasks);
+}
+
+// Submission cost per task: enqueue (packaged_task + future) vs post with a
+// Completion, in bursts of kBurst on one worker
+constexpr std::int64_t kBurst = 1024;
+
+void BM_Submit_Enqueue(benchmark::State &state)
+{
+    quick::thread::ThreadPool pool(1);
+    std::vector<std::future<void>> futures;
+    futures.reserve(kBurst);
+
+    const auto allocs_before = quick::bench::allocation_count();
+    for (auto _ : state)
+    {
+        for (std::int64_t i = 0; i < kBurst; ++i)
+            futures.push_back(pool.enqueue(tiny_work));
+        for (auto &future : futures)
+            future.get();
+        futures.clear();
+    }
+    const auto allocs = quick::bench::allocation_count() - allocs_before;
+
+    state.SetItemsProcessed(state.iterations() * kBurst);
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocs) / static_cast<double>(kBurst),
+                                                     benchmark::Counter::kAvgIterations);
+}
+
+void BM_Submit_Post(benchmark::State &state)
+{
+    quick::thread::ThreadPool pool(1);
+    quick::thread::Completion completion;
+
+    const auto allocs_before = quick::bench::allocation_count();
+    for (auto _ : state)
+    {
+        for (std::int64_t i = 0; i < kBurst; ++i)
+            pool.post(completion, tiny_work);
+        completion.wait();
+    }
+    const auto allocs = quick::bench::allocation_count() - allocs_before;
+
+    state.SetItemsProcessed(state.iterations() * kBurst);
+    state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(allocs) / static_cast<double>(kBurst),
+                                                     benchmark::Counter::kAvgIterations);
+}
+
+// Sum of 4M doubles: hand-chunked enqueue + a vector of futures (what
+// callers used to write) vs parallel_reduce, where the caller does a share
+constexpr std::size_t kReduceCount = std::size_t{1} << 22;
+
+void BM_Reduce_Futures(benchmark::State &state)
+{
+    const auto workers = static_cast<std::size_t>(state.range(0));
+    quick::thread::ThreadPool pool(workers);
+    std::vector<double> values(kReduceCount, 0.5);
+    const std::size_t chunk = kReduceCount / (8 * workers);
+    for (auto _ : state)
+    {
+        std::vector<std::future<double>> partials;
+        for (std::size_t first = 0; first < kReduceCount; first += chunk)
+            partials.push_back(pool.enqueue([&values, first, chunk] {
+                const auto begin = values.begin() + static_cast<std::ptrdiff_t>(first);
+                return std::accumulate(begin, begin + static_cast<std::ptrdiff_t>(chunk), 0.0);
+            }));
+        double sum = 0;
+        for (auto &partial : partials)
+            sum += partial.get();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kReduceCount));
+}
+
+void BM_Reduce_Parallel(benchmark::State &state)
+{
+    quick::thread::ThreadPool pool(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> values(kReduceCount, 0.5);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(pool.parallel_reduce(values, 0, 0.0, std::plus<>{}));
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(kReduceCount));
+}
+
+// Queueing delay of one probe task posted behind a backlog of 2000
+// background tasks, with the probe at Arg(0) priority (0 = URGENT,
+// 2 = BACKGROUND, i.e. plain FIFO behind the backlog)
+void BM_Priority_ProbeDelay(benchmark::State &state)
+{
+    using clock = std::chrono::steady_clock;
+    const auto priority = static_cast<quick::thread::Priority>(state.range(0));
+    quick::thread::ThreadPool pool(2);
+    double delay_ns = 0;
+    for (auto _ : state)
+    {
+        quick::thread::Completion completion;
+        for (int i = 0; i < 2000; ++i)
+            pool.post(quick::thread::Priority::BACKGROUND, completion, tiny_work);
+        const auto posted = clock::now();
+        std::atomic<clock::rep> started{0};
+        pool.post(priority, completion, [&] { started.store((clock::now() - posted).count()); });
+        completion.wait();
+        delay_ns += static_cast<double>(std::chrono::nanoseconds(clock::duration(started.load())).count());
+    }
+    state.counters["probe_delay_us"] = benchmark::Counter(delay_ns / 1000.0, benchmark::Counter::kAvgIterations);
+}
+
+// 1, 2, 4, ... workers up to one per core (at least 4)
+void WorkerArgs(benchmark::internal::Benchmark *bench)
+{
+    const std::int64_t max_workers = std::max<std::int64_t>(4, std::thread::hardware_concurrency());
+    bench->ArgName("workers");
+    for (std::int64_t workers = 1; workers <= max_workers; workers *= 2)
+        bench->Arg(workers);
+    bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+} // namespace
+
+BENCHMARK(BM_Submit_Enqueue)->UseRealTime();
+BENCHMARK(BM_Submit_Post)->UseRealTime();
+BENCHMARK(BM_Reduce_Futures)->Apply(WorkerArgs);
+BENCHMARK(BM_Reduce_Parallel)->Apply(WorkerArgs);
+BENCHMARK(BM_Priority_ProbeDelay)
+    ->ArgName("priority")
+    ->Arg(0)
+    ->Arg(2)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Pool_FlatTasks<quick::bench::MutexThreadPool>)->Apply(WorkerArgs);
+BENCHMARK(BM_Pool_FlatTasks<quick::thread::ThreadPool>)->Apply(WorkerArgs);
+BENCHMARK(BM_Pool_TaskTree<quick::bench::MutexThreadPool>)->Apply(WorkerArgs);
+BENCHMARK(BM_Pool_TaskTree<quick::thread::ThreadPool>)->Apply(WorkerArgs);
@@ -0,0 +1,38 @@
+// C++ Includes
+#include <cstdint>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+// QuickLib Includes
+#include "LockingQueue.hh"
+#include "bench_utils.hh"
+#include "quick/structs/ThreadSafeQueue.hh"
+
+namespace
+{
+// Uncontended push + pop on one thread: the fixed cost every op pays for
+// locking/notifying and for std::deque's block allocations
+template <class Queue> void BM_RoundTrip(benchmark::State &state)
+{
+    auto queue = std::make_unique<Queue>();
+    std::int64_t i = 0;
+
+    const auto allocs_before = quick::bench::allocation_count();
+    for (auto _ : state)
+    {
+        for (std::int64_t burst = 0; burst < 512; ++burst)
+            queue->push(i++);
+        for (std::int64_t burst = 0; burst < 512; ++burst)
+            benchmark::DoNotOptimize(queue->wait_and_pop());
+    }
+    const auto allocs = quick::bench::allocation_count() - allocs_before;
+
+    state.SetItemsProcessed(state.iterations() * 512);
+    state.counters["allocs/op"] =
+        benchmark::Counter(static_cast<double>(allocs) / 512.0, benchmark::Counter::kAvgIterations);
+}
+} // namespace
+
+BENCHMARK(BM_RoundTrip<quick::bench::LockingQueue<std::int64_t>>);
+BENCHMARK(BM_RoundTrip<quick::structs::ThreadSafeQueue<std::int64_t>>);
@@ -0,0 +1,78 @@
+#include "bench_utils.hh"
+
+// C++ Includes
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<std::uint64_t> g_allocations{0};
+} // namespace
+
+std::uint64_t quick::bench::allocation_count() noexcept
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+// Replaceable global allocation functions. Every allocating form is
+// replaced so each call is counted once; the array forms forward to these by
+// default.
+void *operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+// Over-aligned types (alignas(64) slots, cache-line padded counters, ...)
+namespace
+{
+void *aligned_malloc(std::size_t size, std::align_val_t align) noexcept
+{
+    const auto alignment = static_cast<std::size_t>(align);
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+} // namespace
+
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = aligned_malloc(size == 0 ? 1 : size, align))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void *operator new(std::size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return aligned_malloc(size == 0 ? 1 : size, align);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
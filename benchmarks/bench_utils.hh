@@ -0,0 +1,95 @@
+#pragma once
+
+// C Includes
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// C++ Includes
+#include <cstdint>
+
+namespace quick::bench
+{
+
+/// @brief Number of global `operator new` calls made so far, across all
+/// threads. Diff it around a benchmark loop to report allocations per op.
+/// @note Defined (together with the counting `operator new`) in bench_utils.cc
+std::uint64_t allocation_count() noexcept;
+
+/// @brief Minor page faults taken by the calling thread so far.
+inline std::uint64_t minor_faults() noexcept
+{
+    rusage usage{};
+    ::getrusage(RUSAGE_THREAD, &usage);
+    return static_cast<std::uint64_t>(usage.ru_minflt);
+}
+
+/// @brief Thin RAII wrapper over one `perf_event_open` hardware counter for
+/// the calling thread (user space only).
+/// @note Counters are often unavailable in containers/VMs
+///       (`perf_event_paranoid`, no PMU passthrough); check `valid()` and
+///       skip the metric instead of reporting zeros.
+class PerfCounter
+{
+  private:
+    int m_fd{-1};
+
+  public:
+    /// @brief Last-level cache misses
+    static constexpr std::uint64_t kCacheMisses = PERF_COUNT_HW_CACHE_MISSES;
+    /// @brief L1 data cache read misses
+    static constexpr std::uint64_t kL1dReadMisses = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    /// @brief Data TLB read misses
+    static constexpr std::uint64_t kDTLBReadMisses = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    explicit PerfCounter(std::uint32_t type, std::uint64_t config) noexcept
+    {
+        perf_event_attr attr{};
+        attr.type = type;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    PerfCounter(const PerfCounter &) = delete;
+    PerfCounter &operator=(const PerfCounter &) = delete;
+
+    ~PerfCounter()
+    {
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    bool valid() const noexcept
+    {
+        return m_fd >= 0;
+    }
+
+    void start() noexcept
+    {
+        if (!valid())
+            return;
+        ::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    std::uint64_t stop() noexcept
+    {
+        std::uint64_t count = 0;
+        if (!valid())
+            return count;
+        ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (::read(m_fd, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count)))
+            return 0;
+        return count;
+    }
+};
+
+} // End namespace quick::bench
@@ -5,6 +5,7 @@
 
 // QuickLib Includes
 #include "quick/structs/SPSCQueue.hh"
+#include "quick/thread/WaitStrategy.hpp"
 
 namespace fiah
 {
@@ -17,12 +18,16 @@ static void ExampleSPSCQueue()
     quick::structs::SPSCQueue<ElementType, N> queue;
     static_assert(queue.capacity() == N);
 
+    // Spin briefly, then sleep on a futex: an idle side stops burning a core.
+    // Swap in BusySpinWait/SpinPauseWait/SpinYieldWait to trade CPU for latency.
+    quick::thread::SpinBlockWait not_empty;
+    quick::thread::SpinBlockWait not_full;
+
     std::thread prod([&] {
         for (int i = 0; i < 100000; ++i)
         {
-            while (!queue.emplace(static_cast<ElementType>(i)))
-            {
-            }
+            quick::thread::push_wait(queue, static_cast<ElementType>(i), not_full);
+            not_empty.notify();
         }
     });
     std::thread cons([&] {
@@ -30,10 +35,9 @@ static void ExampleSPSCQueue()
         std::uint64_t cnt = 0;
         while (cnt < 100000)
         {
-            if (queue.pop(v))
-            {
-                ++cnt;
-            }
+            quick::thread::pop_wait(queue, v, not_empty);
+            not_full.notify();
+            ++cnt;
         }
         std::cout << "Got: " << cnt << " items\n";
     });
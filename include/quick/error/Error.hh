@@ -34,6 +34,13 @@ enum class Error : std::uint8_t
 };
 #pragma pack(pop)
 
+enum class OrderbookError : std::uint8_t
+{
+    DUPLICATE_ORDER_ID,
+    PRICE_OUT_OF_RANGE,
+    POOL_EXHAUSTED
+};
+
 enum class TcpError : std::uint8_t
 {
     BAD_SOCKET,
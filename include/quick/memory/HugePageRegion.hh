@@ -0,0 +1,148 @@
+#pragma once
+
+// C Includes
+#include <sys/mman.h>
+
+// C++ Includes
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace quick::memory
+{
+
+/// @brief What a `HugePageRegion` asks the kernel for.
+enum class HugePages : std::uint8_t
+{
+    NONE,        ///< Plain 4 KiB pages
+    TRANSPARENT, ///< 2 MiB-aligned mapping + `MADV_HUGEPAGE` (THP, best effort)
+    EXPLICIT     ///< `MAP_HUGETLB` from the reserved pool, THP if that fails
+};
+
+/// @brief What the region actually got.
+enum class PageBacking : std::uint8_t
+{
+    NORMAL,
+    TRANSPARENT, ///< THP was requested; the kernel may still have used 4 KiB pages
+    HUGETLB
+};
+
+/// @brief Anonymous, page-aligned memory mapping, optionally backed by
+/// 2 MiB pages so large rings take a fraction of the page faults and TLB
+/// entries. Always at least cache-line aligned.
+class HugePageRegion
+{
+  public:
+    static constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+  private:
+    void *p_data{nullptr};
+    std::size_t m_bytes{0};
+    PageBacking m_backing{PageBacking::NORMAL};
+
+    static std::size_t round_up(std::size_t bytes, std::size_t to) noexcept
+    {
+        return (bytes + to - 1) & ~(to - 1);
+    }
+
+    void map_transparent(std::size_t bytes)
+    {
+        // Over-map by one huge page and trim, so the region starts on a 2 MiB
+        // boundary and khugepaged can back it with whole huge pages
+        m_bytes = round_up(bytes, kHugePageSize);
+        void *raw = ::mmap(nullptr, m_bytes + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED)
+            throw std::bad_alloc{};
+        auto *base = static_cast<std::byte *>(raw);
+        auto *aligned = reinterpret_cast<std::byte *>(
+            round_up(reinterpret_cast<std::uintptr_t>(base), kHugePageSize));
+        if (aligned != base)
+            ::munmap(base, static_cast<std::size_t>(aligned - base));
+        if (const std::size_t tail = kHugePageSize - static_cast<std::size_t>(aligned - base); tail != 0)
+            ::munmap(aligned + m_bytes, tail);
+        p_data = aligned;
+        m_backing = ::madvise(p_data, m_bytes, MADV_HUGEPAGE) == 0 ? PageBacking::TRANSPARENT : PageBacking::NORMAL;
+    }
+
+  public:
+    HugePageRegion() noexcept = default;
+
+    /// @param bytes Usable size; rounded up to the page size in use
+    /// @param pages Requested backing (falls back silently, see `backing()`)
+    /// @param prefault Touch every page now instead of on first use
+    /// @throws std::bad_alloc if no mapping could be made
+    HugePageRegion(std::size_t bytes, HugePages pages, bool prefault = true)
+    {
+        switch (pages)
+        {
+        case HugePages::EXPLICIT:
+            m_bytes = round_up(bytes, kHugePageSize);
+            p_data = ::mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p_data != MAP_FAILED)
+            {
+                m_backing = PageBacking::HUGETLB;
+                break;
+            }
+            p_data = nullptr;
+            map_transparent(bytes); // No reserved huge pages (vm.nr_hugepages)
+            break;
+        case HugePages::TRANSPARENT:
+            map_transparent(bytes);
+            break;
+        case HugePages::NONE:
+            m_bytes = round_up(bytes, 4096);
+            p_data = ::mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p_data == MAP_FAILED)
+                throw std::bad_alloc{};
+            break;
+        }
+        if (prefault)
+            std::memset(p_data, 0, m_bytes);
+    }
+
+    HugePageRegion(HugePageRegion &&other) noexcept
+        : p_data{std::exchange(other.p_data, nullptr)}, m_bytes{std::exchange(other.m_bytes, 0)},
+          m_backing{other.m_backing}
+    {
+    }
+
+    HugePageRegion &operator=(HugePageRegion &&other) noexcept
+    {
+        if (this != &other)
+        {
+            HugePageRegion dying{std::move(*this)};
+            p_data = std::exchange(other.p_data, nullptr);
+            m_bytes = std::exchange(other.m_bytes, 0);
+            m_backing = other.m_backing;
+        }
+        return *this;
+    }
+
+    HugePageRegion(const HugePageRegion &) = delete;
+    HugePageRegion &operator=(const HugePageRegion &) = delete;
+
+    ~HugePageRegion()
+    {
+        if (p_data)
+            ::munmap(p_data, m_bytes);
+    }
+
+    std::byte *data() const noexcept
+    {
+        return static_cast<std::byte *>(p_data);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_bytes;
+    }
+
+    PageBacking backing() const noexcept
+    {
+        return m_backing;
+    }
+};
+
+} // End namespace quick::memory
@@ -0,0 +1,151 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// QuickLib Includes
+#include "quick/structs/SPSCQueue.hh"
+
+namespace quick::structs
+{
+
+/// @brief Single-producer, multi-consumer sequenced ring (disruptor style):
+/// every message is written once and read in place by every consumer.
+/// Each consumer owns a cursor; the producer may only reuse a slot once the
+/// slowest cursor has moved past it, so a stalled consumer applies
+/// backpressure instead of missing data. Both sides cache the other side's
+/// position and only re-read it when the cached value can't satisfy the
+/// call, like `SPSCQueue`.
+///
+/// Threading contract: one producer thread; consumer `i` (0 <= i <
+/// `consumers()`) is polled from one thread at a time.
+/// @tparam T Default-constructible; slots are preallocated and reused, so the
+///         producer writes into them rather than constructing
+/// @tparam CapacityPow2 Power-of-two number of slots
+template <class T, std::uint64_t CapacityPow2> class BroadcastRing
+{
+    static_assert(std::is_default_constructible_v<T>, "BroadcastRing preallocates its slots");
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
+    static constexpr std::uint64_t kCapacity = CapacityPow2;
+    static constexpr std::uint64_t kMask = kCapacity - 1;
+
+    struct alignas(cacheline_t::value) Cursor
+    {
+        std::atomic<std::uint64_t> next{0}; // first sequence not yet read; written by its consumer
+        std::uint64_t published_cache{0};   // consumer's view of m_published
+    };
+
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_published{0}; // sequences [0, m_published) are readable
+    std::uint64_t m_next{0};                                               // producer only
+    std::uint64_t m_gate_cache{0};                                         // producer's view of the slowest cursor
+
+    std::unique_ptr<Cursor[]> p_cursors;
+    std::size_t m_consumers;
+    std::unique_ptr<T[]> p_slots{std::make_unique<T[]>(kCapacity)};
+
+    std::uint64_t slowest_cursor() const noexcept
+    {
+        std::uint64_t slowest = m_next;
+        for (std::size_t i = 0; i < m_consumers; ++i)
+            slowest = std::min(slowest, p_cursors[i].next.load(std::memory_order_acquire));
+        return slowest;
+    }
+
+  public:
+    /// @param consumers Number of independent readers, fixed for the ring's
+    ///        lifetime (every one of them gates the producer)
+    explicit BroadcastRing(std::size_t consumers)
+        : p_cursors{std::make_unique<Cursor[]>(consumers)}, m_consumers{consumers}
+    {
+        assert(consumers > 0);
+    }
+
+    BroadcastRing(const BroadcastRing &) = delete;
+    BroadcastRing &operator=(const BroadcastRing &) = delete;
+
+    /// @brief Producer, step 1: the next slot to fill in place.
+    /// Calling again before `publish()` returns the same slot.
+    /// @return nullptr if the slowest consumer is a whole ring behind
+    T *claim() noexcept
+    {
+        if (m_next - m_gate_cache == kCapacity) [[unlikely]]
+        {
+            m_gate_cache = slowest_cursor();
+            if (m_next - m_gate_cache == kCapacity)
+                return nullptr;
+        }
+        return &p_slots[m_next & kMask];
+    }
+
+    /// @brief Producer, step 2: makes the claimed slot visible to every
+    /// consumer.
+    void publish() noexcept
+    {
+        m_published.store(++m_next, std::memory_order_release);
+    }
+
+    /// @brief Producer: claim + copy-assign + publish.
+    /// @return false if the ring is full
+    template <class U> bool try_publish(U &&value)
+    {
+        T *slot = claim();
+        if (!slot)
+            return false;
+        *slot = std::forward<U>(value);
+        publish();
+        return true;
+    }
+
+    /// @brief Consumer `consumer`: hands up to `max_items` unread messages,
+    /// oldest first, to `fn(const T&)`, in place, then releases them all
+    /// with one store.
+    /// @return Number of messages read
+    template <class Fn> std::size_t poll(std::size_t consumer, Fn &&fn, std::size_t max_items = SIZE_MAX)
+    {
+        assert(consumer < m_consumers);
+        Cursor &cursor = p_cursors[consumer];
+        const std::uint64_t next = cursor.next.load(std::memory_order_relaxed);
+        // Same refresh rule as SPSCQueue::pop_bulk: only when the cached view
+        // can't satisfy the request
+        if (cursor.published_cache - next < max_items)
+        {
+            cursor.published_cache = m_published.load(std::memory_order_acquire);
+            if (cursor.published_cache == next)
+                return 0;
+        }
+
+        const std::uint64_t n = std::min<std::uint64_t>(cursor.published_cache - next, max_items);
+        for (std::uint64_t seq = next; seq < next + n; ++seq)
+            fn(std::as_const(p_slots[seq & kMask]));
+        // Release: the producer may overwrite these slots once it sees this
+        cursor.next.store(next + n, std::memory_order_release);
+        return static_cast<std::size_t>(n);
+    }
+
+    /// @brief Messages published but not yet read by `consumer` (approximate
+    /// from other threads).
+    std::uint64_t lag(std::size_t consumer) const noexcept
+    {
+        return m_published.load(std::memory_order_acquire) -
+               p_cursors[consumer].next.load(std::memory_order_acquire);
+    }
+
+    std::size_t consumers() const noexcept
+    {
+        return m_consumers;
+    }
+
+    static constexpr std::uint64_t capacity() noexcept
+    {
+        return kCapacity;
+    }
+};
+
+} // End namespace quick::structs
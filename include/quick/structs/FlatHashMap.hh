@@ -0,0 +1,179 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace quick::structs
+{
+
+/// @brief Open-addressing hash map for integral keys (order ids, sequence
+/// numbers, ...).
+/// Linear probing over a power-of-two table of inline slots, Fibonacci hashing
+/// and backward-shift deletion (no tombstones), so lookups stay short no
+/// matter how many erases happened. The table doubles once it is half full;
+/// call `reserve()` up front to keep the hot path allocation-free.
+/// @tparam Key Unsigned integral key
+/// @tparam Value Trivially movable payload stored inline in the slot
+template <std::unsigned_integral Key, class Value> class FlatHashMap
+{
+    static constexpr std::uint64_t kFibonacci = 0x9E3779B97F4A7C15ULL;
+    static constexpr std::size_t kMinCapacity = 16;
+
+    struct Slot
+    {
+        Key key{};
+        Value value{};
+        bool used{false};
+    };
+
+    std::vector<Slot> m_slots;
+    std::size_t m_mask{0};
+    std::size_t m_shift{0};
+    std::size_t m_size{0};
+
+    std::size_t home(Key key) const noexcept
+    {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(key) * kFibonacci) >> m_shift);
+    }
+
+    void rehash(std::size_t capacity)
+    {
+        std::vector<Slot> old = std::exchange(m_slots, std::vector<Slot>(capacity));
+        m_mask = capacity - 1;
+        m_shift = 64 - static_cast<std::size_t>(std::countr_zero(capacity));
+        m_size = 0;
+        for (Slot &slot : old)
+            if (slot.used)
+                insert(slot.key, std::move(slot.value));
+    }
+
+  public:
+    FlatHashMap()
+    {
+        rehash(kMinCapacity);
+    }
+
+    explicit FlatHashMap(std::size_t expected) : FlatHashMap()
+    {
+        reserve(expected);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return m_slots.size();
+    }
+
+    /// @brief Grow so that `expected` keys fit without another rehash
+    void reserve(std::size_t expected)
+    {
+        const std::size_t needed = std::bit_ceil(std::max(expected * 2, kMinCapacity));
+        if (needed > m_slots.size())
+            rehash(needed);
+    }
+
+    void clear() noexcept
+    {
+        for (Slot &slot : m_slots)
+            slot.used = false;
+        m_size = 0;
+    }
+
+    Value *find(Key key) noexcept
+    {
+        for (std::size_t i = home(key);; i = (i + 1) & m_mask)
+        {
+            Slot &slot = m_slots[i];
+            if (!slot.used)
+                return nullptr;
+            if (slot.key == key)
+                return &slot.value;
+        }
+    }
+
+    const Value *find(Key key) const noexcept
+    {
+        return const_cast<FlatHashMap *>(this)->find(key);
+    }
+
+    /// @brief Starts pulling `key`'s home slot into cache ahead of a lookup
+    /// (batch paths issue this a few keys ahead).
+    void prefetch(Key key) const noexcept
+    {
+        __builtin_prefetch(&m_slots[home(key)]);
+    }
+
+    bool contains(Key key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    /// @brief Inserts `key` if absent.
+    /// @return false (and leaves the map untouched) if `key` already exists
+    bool insert(Key key, Value value)
+    {
+        if ((m_size + 1) * 2 > m_slots.size()) [[unlikely]]
+            rehash(m_slots.size() * 2);
+
+        for (std::size_t i = home(key);; i = (i + 1) & m_mask)
+        {
+            Slot &slot = m_slots[i];
+            if (!slot.used)
+            {
+                slot.key = key;
+                slot.value = std::move(value);
+                slot.used = true;
+                ++m_size;
+                return true;
+            }
+            if (slot.key == key)
+                return false;
+        }
+    }
+
+    /// @brief Removes `key`, shifting later entries of its probe chain back
+    /// into the hole so no tombstone is left behind.
+    bool erase(Key key) noexcept
+    {
+        std::size_t hole = home(key);
+        for (;; hole = (hole + 1) & m_mask)
+        {
+            if (!m_slots[hole].used)
+                return false;
+            if (m_slots[hole].key == key)
+                break;
+        }
+
+        for (std::size_t i = (hole + 1) & m_mask; m_slots[i].used; i = (i + 1) & m_mask)
+        {
+            // Move slot i into the hole unless its home lies cyclically in (hole, i]
+            const std::size_t ideal = home(m_slots[i].key);
+            if (((i - ideal) & m_mask) >= ((i - hole) & m_mask))
+            {
+                m_slots[hole] = std::move(m_slots[i]);
+                hole = i;
+            }
+        }
+        m_slots[hole].used = false;
+        --m_size;
+        return true;
+    }
+};
+
+} // End namespace quick::structs
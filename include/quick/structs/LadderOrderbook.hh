@@ -0,0 +1,471 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "quick/error/Error.hh"
+#include "quick/structs/FlatHashMap.hh"
+#include "quick/structs/Orderbook.hh"
+#include "quick/structs/SlabPool.hh"
+#include "quick/structs/TickBitmap.hh"
+
+/// @brief Price-level ladder order book.
+/// Levels live in a flat array indexed by tick offset from `min_price`, each
+/// holding a FIFO of resting orders. A `TickBitmap` per side tracks which
+/// levels are occupied, so best bid/ask is O(1) and inserting an order never
+/// shifts any other order (unlike the sorted vectors in `Orderbook`).
+///
+/// Matching semantics (price-time priority, trade pricing, dupe rejection)
+/// are identical to `Orderbook`, so the two are interchangeable behind
+/// `OrderbookEngine`.
+///
+/// Resting orders live in a `SlabPool` sized at construction and are linked
+/// intrusively (prev/next handles) into their level, so inserts and cancels
+/// never move another order and never call the global allocator. An
+/// id -> handle index makes dedupe, cancel and reduce O(1).
+///
+/// Order storage is split structure-of-arrays style: the pool holds the
+/// 16-byte `HotOrder` (id, qty, next) that the matching loop walks, four to a
+/// cache line, while price/side/prev sit in a parallel `ColdOrder` array
+/// that only cancels and reduces touch. A level's price is its tick, so
+/// matching never reads a per-order price at all.
+///
+/// Every level also carries its L2 aggregates (total size, order count),
+/// updated in step with each insert/fill/cancel/reduce. Levels whose
+/// aggregates changed are queued once (coalesced) for
+/// `PublishDepthUpdates`, so publishing depth after an event costs
+/// O(levels changed), and `DepthSnapshot` walks only the top N levels.
+/// @attention Orders priced outside [min_price, max_price] are rejected the
+///            same way duplicates are: no trades, nothing rests. Use
+///            `TryAddOrder` to find out why an order was rejected.
+class LadderOrderbook
+{
+  public:
+    static constexpr inline Price default_min_price_ = 0;
+    static constexpr inline Price default_max_price_ = (Price{1} << 16) - 1;
+    static constexpr inline std::uint32_t default_capacity_ = 1U << 16;
+    static constexpr inline std::size_t batch_prefetch_distance_ = 8;
+
+  private:
+    using Handle = std::uint32_t;
+
+    // Everything the matching loop reads
+    struct HotOrder
+    {
+        Id id;
+        Quantity qty;
+        Handle next;
+    };
+    static_assert(sizeof(HotOrder) == 16);
+
+    // Only needed to unlink an order from the middle of its level. `prev` is
+    // not maintained for a level's head, which is always unlinked via `head`.
+    struct ColdOrder
+    {
+        Price level;
+        Handle prev;
+        bool is_buy;
+    };
+
+    using Pool = quick::structs::SlabPool<HotOrder>;
+    static_assert(std::is_same_v<Handle, Pool::Handle>);
+    static constexpr Handle null_ = Pool::npos;
+
+    struct PriceLevel
+    {
+        Handle head{null_}; // Oldest order, next to fill
+        Handle tail{null_};
+        std::int64_t total_qty{0};
+        std::uint32_t order_count{0};
+        bool dirty{false}; // Already queued in `dirty_` for the next publish
+
+        bool empty() const noexcept
+        {
+            return head == null_;
+        }
+    };
+
+    using Ladder = std::vector<PriceLevel>;
+
+    struct DirtyLevel
+    {
+        std::size_t tick;
+        bool is_buy;
+    };
+
+    Price min_price_;
+    Price max_price_;
+    Ladder bids_;
+    Ladder asks_;
+    quick::structs::TickBitmap bid_ticks_;
+    quick::structs::TickBitmap ask_ticks_;
+    Pool pool_;
+    std::vector<ColdOrder> cold_;
+    quick::structs::FlatHashMap<Id, Handle> index_;
+    std::vector<DirtyLevel> dirty_;
+
+    std::size_t tick_of(Price level) const noexcept
+    {
+        return static_cast<std::size_t>(level - min_price_);
+    }
+
+    Price price_of(std::size_t tick) const noexcept
+    {
+        return min_price_ + static_cast<Price>(tick);
+    }
+
+    static std::size_t ladder_size(Price min_price, Price max_price) noexcept
+    {
+        assert(min_price <= max_price);
+        return static_cast<std::size_t>(max_price - min_price) + 1;
+    }
+
+    void mark_dirty(PriceLevel &level, bool is_buy, std::size_t tick)
+    {
+        if (level.dirty)
+            return;
+        level.dirty = true;
+        dirty_.push_back(DirtyLevel{tick, is_buy});
+    }
+
+    // Unlinks a resting order from anywhere in its level and gives its slot
+    // back to the pool (the caller fixes up the index)
+    void remove(Handle h)
+    {
+        const ColdOrder &cold = cold_[h];
+        const std::size_t tick = tick_of(cold.level);
+        PriceLevel &level = cold.is_buy ? bids_[tick] : asks_[tick];
+
+        if (level.head == h)
+        {
+            pop_front(level, cold.is_buy, tick);
+            return;
+        }
+        const Handle next = pool_[h].next;
+        pool_[cold.prev].next = next;
+        if (level.tail == h)
+            level.tail = cold.prev;
+        else
+            cold_[next].prev = cold.prev;
+        level.total_qty -= pool_[h].qty;
+        --level.order_count;
+        mark_dirty(level, cold.is_buy, tick);
+        pool_.release(h);
+    }
+
+    // Fill path: only touches the hot array
+    void pop_front(PriceLevel &level, bool is_buy, std::size_t tick)
+    {
+        const Handle h = level.head;
+        level.head = pool_[h].next;
+        level.total_qty -= pool_[h].qty;
+        --level.order_count;
+        mark_dirty(level, is_buy, tick);
+        if (level.head == null_)
+        {
+            level.tail = null_;
+            (is_buy ? bid_ticks_ : ask_ticks_).clear(tick);
+        }
+        pool_.release(h);
+    }
+
+  public:
+    /// @param max_resting_orders Pool capacity; orders that would rest beyond
+    ///        it are rejected with `OrderbookError::POOL_EXHAUSTED`
+    explicit LadderOrderbook(Price min_price = default_min_price_, Price max_price = default_max_price_,
+                             std::uint32_t max_resting_orders = default_capacity_)
+        : min_price_{min_price}, max_price_{max_price}, bids_(ladder_size(min_price, max_price)),
+          asks_(ladder_size(min_price, max_price)), bid_ticks_{ladder_size(min_price, max_price)},
+          ask_ticks_{ladder_size(min_price, max_price)}, pool_{max_resting_orders}, cold_(max_resting_orders),
+          index_{max_resting_orders}
+    {
+        // Each level is queued at most once per publish, so this is the most
+        // mark_dirty can ever need: it never allocates on the hot path
+        dirty_.reserve(2 * ladder_size(min_price, max_price));
+    }
+
+    Price min_price() const noexcept
+    {
+        return min_price_;
+    }
+
+    Price max_price() const noexcept
+    {
+        return max_price_;
+    }
+
+    bool in_range(Price level) const noexcept
+    {
+        return level >= min_price_ && level <= max_price_;
+    }
+
+    std::uint32_t capacity() const noexcept
+    {
+        return pool_.capacity();
+    }
+
+    std::uint32_t resting_orders() const noexcept
+    {
+        return pool_.size();
+    }
+
+    std::optional<Price> best_bid() const noexcept
+    {
+        if (bid_ticks_.empty())
+            return std::nullopt;
+        return price_of(bid_ticks_.max());
+    }
+
+    std::optional<Price> best_ask() const noexcept
+    {
+        if (ask_ticks_.empty())
+            return std::nullopt;
+        return price_of(ask_ticks_.min());
+    }
+
+    bool is_dupe(const Order &order) const noexcept
+    {
+        return index_.contains(order.get_id());
+    }
+
+    /// @brief Rests `order` at the back of its level.
+    /// @return false if the id is already resting or the pool is exhausted
+    bool insert_order(const Order &order)
+    {
+        assert(in_range(order.get_level()));
+        if (is_dupe(order))
+            return false;
+        const Handle h = pool_.emplace(HotOrder{order.get_id(), order.get_qty(), null_});
+        if (h == null_) [[unlikely]]
+            return false;
+        index_.insert(order.get_id(), h);
+
+        const std::size_t tick = tick_of(order.get_level());
+        PriceLevel &level = order.is_buy() ? bids_[tick] : asks_[tick];
+        cold_[h] = ColdOrder{order.get_level(), level.tail, order.is_buy()};
+        if (level.empty())
+        {
+            level.head = h;
+            (order.is_buy() ? bid_ticks_ : ask_ticks_).set(tick);
+        }
+        else
+            pool_[level.tail].next = h;
+        level.tail = h;
+        level.total_qty += order.get_qty();
+        ++level.order_count;
+        mark_dirty(level, order.is_buy(), tick);
+        return true;
+    }
+
+    [[nodiscard]]
+    Trades AddOrder(const Order &incoming)
+    {
+        Trades trades;
+        AddOrder(incoming, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Same matching as `AddOrder(incoming)`, but fills go straight to
+    /// `sink` instead of a freshly allocated `Trades`.
+    /// @return Number of trades emitted
+    template <TradeSink Sink> std::size_t AddOrder(const Order &incoming, Sink &&sink)
+    {
+        std::size_t n_trades = 0;
+        (void)TryAddOrder(incoming, [&](const Trade &trade) {
+            sink(trade);
+            ++n_trades;
+        });
+        return n_trades;
+    }
+
+    /// @brief `AddOrder` that reports why an order was (partly) rejected.
+    /// @return Number of trades emitted, or the rejection reason. On
+    ///         `POOL_EXHAUSTED` the fills already handed to `sink` stand and
+    ///         only the unfilled remainder is dropped.
+    template <TradeSink Sink>
+    std::expected<std::size_t, quick::error::OrderbookError> TryAddOrder(const Order &incoming, Sink &&sink)
+    {
+        if (!in_range(incoming.get_level())) [[unlikely]]
+            return std::unexpected(quick::error::OrderbookError::PRICE_OUT_OF_RANGE);
+        if (is_dupe(incoming)) [[unlikely]]
+            return std::unexpected(quick::error::OrderbookError::DUPLICATE_ORDER_ID);
+
+        std::size_t n_trades = 0;
+        auto &opposite_side = incoming.is_buy() ? asks_ : bids_;
+        auto &opposite_ticks = incoming.is_buy() ? ask_ticks_ : bid_ticks_;
+
+        Quantity remaining = incoming.get_qty();
+
+        while (!opposite_ticks.empty() and remaining > 0)
+        {
+            const std::size_t best_tick = incoming.is_buy() ? opposite_ticks.min() : opposite_ticks.max();
+            const Price best_level = price_of(best_tick);
+            bool match = incoming.is_buy() ? incoming.get_level() >= best_level : best_level >= incoming.get_level();
+            if (!match)
+                break;
+
+            PriceLevel &level = opposite_side[best_tick];
+            while (!level.empty() and remaining > 0)
+            {
+                HotOrder &best = pool_[level.head];
+                Quantity trade_size = std::min(best.qty, remaining);
+
+                // Price is ALWAYS from the ask (sell) side, trade format is
+                // bid order first, then ask order (see `Orderbook::AddOrder`)
+                Price trade_price = incoming.is_buy() ? best_level : incoming.get_level();
+                Id bid_order_id = incoming.is_buy() ? incoming.get_id() : best.id;
+                Id ask_order_id = incoming.is_buy() ? best.id : incoming.get_id();
+
+                sink(Trade{bid_order_id, ask_order_id, incoming.get_id(), incoming.is_buy(), trade_price, trade_size});
+                ++n_trades;
+
+                best.qty -= trade_size;
+                level.total_qty -= trade_size;
+                remaining -= trade_size;
+
+                if (best.qty == 0)
+                {
+                    index_.erase(best.id);
+                    pop_front(level, !incoming.is_buy(), best_tick);
+                }
+                else
+                    mark_dirty(level, !incoming.is_buy(), best_tick);
+            }
+        }
+
+        if (remaining > 0)
+        {
+            Order corrected_incoming = incoming;
+            corrected_incoming.set_qty(remaining);
+            if (!insert_order(corrected_incoming)) [[unlikely]]
+                return std::unexpected(quick::error::OrderbookError::POOL_EXHAUSTED);
+        }
+        return n_trades;
+    }
+
+    void CancelOrder(Id order_id)
+    {
+        const Handle *h = index_.find(order_id);
+        if (!h)
+            return;
+        const Handle victim = *h;
+        index_.erase(order_id);
+        remove(victim);
+    }
+
+    /// @brief Takes `reduce_by` off a resting order without losing its place
+    /// in the queue. Reducing to zero or below cancels it; a non-positive
+    /// `reduce_by` (which would grow the order in place) is ignored.
+    void ReduceOrder(Id order_id, Quantity reduce_by)
+    {
+        if (reduce_by <= 0) [[unlikely]]
+            return;
+        const Handle *h = index_.find(order_id);
+        if (!h)
+            return;
+        HotOrder &order = pool_[*h];
+        if (order.qty <= reduce_by)
+        {
+            CancelOrder(order_id);
+            return;
+        }
+        order.qty -= reduce_by;
+
+        const ColdOrder &cold = cold_[*h];
+        const std::size_t tick = tick_of(cold.level);
+        PriceLevel &level = cold.is_buy ? bids_[tick] : asks_[tick];
+        level.total_qty -= reduce_by;
+        mark_dirty(level, cold.is_buy, tick);
+    }
+
+    [[nodiscard]]
+    Trades ModifyOrder(Id order_id, Price new_level, Quantity new_qty)
+    {
+        Trades trades;
+        ModifyOrder(order_id, new_level, new_qty, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Changes a resting order's price and/or size. A pure size
+    /// decrease keeps its queue position (see `ReduceOrder`); a price change
+    /// or size increase requeues it at the back of its new level, where it
+    /// may trade like a fresh `AddOrder`. Unknown ids and moves outside the
+    /// ladder are ignored (the order stays as it was).
+    /// @return Number of trades emitted
+    template <TradeSink Sink> std::size_t ModifyOrder(Id order_id, Price new_level, Quantity new_qty, Sink &&sink)
+    {
+        const Handle *h = index_.find(order_id);
+        if (!h || !in_range(new_level))
+            return 0;
+        const Quantity qty = pool_[*h].qty;
+        const ColdOrder cold = cold_[*h];
+        if (new_level == cold.level && new_qty <= qty)
+        {
+            ReduceOrder(order_id, qty - new_qty);
+            return 0;
+        }
+        CancelOrder(order_id);
+        return AddOrder(Order{order_id, new_level, cold.is_buy, new_qty}, sink);
+    }
+
+    /// @brief Applies `commands` in order with a single sink, prefetching the
+    /// index slot of the command `batch_prefetch_distance_` ahead so dedupe
+    /// and cancel lookups rarely wait on memory. Same trades as applying the
+    /// commands one by one.
+    /// @return Number of trades emitted
+    template <TradeSink Sink> std::size_t ApplyBatch(std::span<const OrderCommand> commands, Sink &&sink)
+    {
+        std::size_t n_trades = 0;
+        for (std::size_t i = 0; i < commands.size(); ++i)
+        {
+            if (i + batch_prefetch_distance_ < commands.size())
+                index_.prefetch(commands[i + batch_prefetch_distance_].id);
+            n_trades += ApplyCommand(*this, commands[i], sink);
+        }
+        return n_trades;
+    }
+
+    /// @brief Fills `out` with the best `out.size()` levels of one side,
+    /// best first.
+    /// @return Number of levels written
+    std::size_t DepthSnapshot(bool is_buy, std::span<DepthLevel> out) const noexcept
+    {
+        const Ladder &ladder = is_buy ? bids_ : asks_;
+        const quick::structs::TickBitmap &ticks = is_buy ? bid_ticks_ : ask_ticks_;
+        std::size_t n = 0;
+        for (std::size_t tick = is_buy ? ticks.max() : ticks.min();
+             tick != quick::structs::TickBitmap::npos && n < out.size();
+             tick = is_buy ? (tick == 0 ? quick::structs::TickBitmap::npos : ticks.prev(tick - 1)) : ticks.next(tick + 1))
+        {
+            const PriceLevel &level = ladder[tick];
+            out[n++] = DepthLevel{price_of(tick), level.total_qty, level.order_count};
+        }
+        return n;
+    }
+
+    /// @brief Hands `fn(const DepthUpdate&)` the current aggregates of every
+    /// level that changed since the previous call, once per level no matter
+    /// how many orders touched it.
+    /// @return Number of updates emitted
+    template <class Fn> std::size_t PublishDepthUpdates(Fn &&fn)
+    {
+        for (const DirtyLevel &dirty : dirty_)
+        {
+            PriceLevel &level = dirty.is_buy ? bids_[dirty.tick] : asks_[dirty.tick];
+            level.dirty = false;
+            fn(DepthUpdate{dirty.is_buy, DepthLevel{price_of(dirty.tick), level.total_qty, level.order_count}});
+        }
+        const std::size_t n = dirty_.size();
+        dirty_.clear();
+        return n;
+    }
+};
+
+static_assert(OrderbookEngine<LadderOrderbook>);
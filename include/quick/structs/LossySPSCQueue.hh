@@ -0,0 +1,131 @@
+#pragma once
+
+// C++ Includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// QuickLib Includes
+#include "quick/structs/SPSCQueue.hh"
+
+namespace quick::structs
+{
+
+/// @brief Single-producer, single-consumer ring that never blocks or fails
+/// the producer: once full, each push overwrites the oldest element.
+/// Meant for feeds where a stale tick is worth less than the latest one.
+///
+/// Every slot carries a sequence number (odd while being written, then
+/// `2 * index + 2`), so the consumer can tell a slot it wanted from one the
+/// producer has since lapped, and a read that raced with a write. Either case
+/// is counted in `missed()` and the consumer moves on; nothing ever waits on
+/// the other thread and no lock is taken.
+/// @tparam T Trivially copyable: a read may be torn and is then thrown away
+/// @tparam CapacityPow2 Power-of-two number of slots
+template <class T, std::uint64_t CapacityPow2> class LossySPSCQueue
+{
+    static_assert(std::is_trivially_copyable_v<T>, "LossySPSCQueue copies elements that may be mid-overwrite");
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
+    static constexpr std::uint64_t kCapacity = CapacityPow2;
+    static constexpr std::uint64_t kMask = kCapacity - 1;
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> seq{0};
+        alignas(T) std::byte data[sizeof(T)];
+    };
+
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_head{0}; // elements ever pushed
+    alignas(cacheline_t::value) std::uint64_t m_read{0};              // consumer's next index
+    std::uint64_t m_missed{0};                                        // consumer-only
+    alignas(cacheline_t::value) Slot m_slots[kCapacity];
+
+    static constexpr std::uint64_t written_seq(std::uint64_t idx) noexcept
+    {
+        return 2 * idx + 2;
+    }
+
+  public:
+    constexpr LossySPSCQueue() = default;
+    LossySPSCQueue(const LossySPSCQueue &) = delete;
+    LossySPSCQueue &operator=(const LossySPSCQueue &) = delete;
+
+    /// @brief Producer only. Always succeeds; overwrites the oldest element
+    /// when the ring is full.
+    void push(const T &x) noexcept
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        Slot &slot = m_slots[head & kMask];
+
+        // Seqlock write: odd sequence first, so a concurrent reader can spot it
+        slot.seq.store(2 * head + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(slot.data, &x, sizeof(T));
+        slot.seq.store(written_seq(head), std::memory_order_release);
+
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /// @brief Consumer only. Pops the oldest element still intact, first
+    /// skipping (and counting) anything the producer overwrote.
+    /// @return false if nothing new has been pushed
+    bool pop(T &out) noexcept
+    {
+        for (;;)
+        {
+            const std::uint64_t head = m_head.load(std::memory_order_acquire);
+            if (head == m_read)
+                return false;
+            // Lapped: everything older than one ring behind head is gone
+            if (head - m_read > kCapacity)
+            {
+                m_missed += head - m_read - kCapacity;
+                m_read = head - kCapacity;
+            }
+
+            const Slot &slot = m_slots[m_read & kMask];
+            const std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+            if (before == written_seq(m_read))
+            {
+                std::memcpy(&out, slot.data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) == before)
+                {
+                    ++m_read;
+                    return true;
+                }
+            }
+            // Overwritten before or while we read it
+            ++m_missed;
+            ++m_read;
+        }
+    }
+
+    /// @brief Elements the consumer never saw because they were overwritten.
+    /// Consumer thread only.
+    std::uint64_t missed() const noexcept
+    {
+        return m_missed;
+    }
+
+    /// @brief Consumer only: nothing new since the last `pop`.
+    bool empty() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire) == m_read;
+    }
+
+    /// @brief Total elements ever pushed (any thread).
+    std::uint64_t pushed() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::uint64_t capacity() noexcept
+    {
+        return kCapacity;
+    }
+};
+
+} // End namespace quick::structs
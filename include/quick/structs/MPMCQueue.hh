@@ -0,0 +1,173 @@
+#pragma once
+
+// C++ Includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// QuickLib Includes
+#include "quick/structs/SPSCQueue.hh"
+
+namespace quick::structs
+{
+
+/// @brief Bounded lock-free multi-producer, multi-consumer queue (Vyukov).
+/// Every slot carries a sequence number that says whose turn it is: `pos`
+/// means free for the producer that claims index `pos`, `pos + 1` means
+/// filled for the consumer that claims `pos`. Producers and consumers each
+/// claim indices with a CAS on their own counter, so the two sides never
+/// touch the same cache line except through the slot they hand over.
+/// @tparam T No array types pls
+/// @tparam CapacityPow2 Capacity should be power of two for logical indexing
+template <class T, std::uint64_t CapacityPow2> class MPMCQueue
+{
+    static_assert(!std::is_array_v<T>, "MPMCQueue does not support array element types");
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
+    static constexpr std::uint64_t kCapacity = CapacityPow2;
+    static constexpr std::uint64_t kMask = kCapacity - 1;
+
+    // One slot per cache line: neighbouring producers/consumers work on
+    // adjacent indices at the same time
+    struct alignas(cacheline_t::value) Slot
+    {
+        std::atomic<std::uint64_t> seq;
+        alignas(T) std::byte data[sizeof(T)];
+
+        T *ptr() noexcept
+        {
+            return std::launder(reinterpret_cast<T *>(data));
+        }
+    };
+
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_head{0}; // next index to produce into
+    alignas(cacheline_t::value) std::atomic<std::uint64_t> m_tail{0}; // next index to consume from
+    std::unique_ptr<Slot[]> p_slots{std::make_unique<Slot[]>(kCapacity)};
+
+    // Claims the oldest element, hands it to `sink` as an rvalue, destroys it
+    // and frees its slot
+    template <class Sink> bool take(Sink &&sink)
+    {
+        std::uint64_t pos = m_tail.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;)
+        {
+            slot = &p_slots[pos & kMask];
+            const std::uint64_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0) [[unlikely]]
+                return false; // Not produced yet
+            else
+                pos = m_tail.load(std::memory_order_relaxed);
+        }
+
+        sink(std::move(*slot->ptr()));
+        std::destroy_at(slot->ptr());
+        // Hand the slot to the producer one lap ahead
+        slot->seq.store(pos + kCapacity, std::memory_order_release);
+        return true;
+    }
+
+  public:
+    MPMCQueue()
+    {
+        for (std::uint64_t i = 0; i < kCapacity; ++i)
+            p_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MPMCQueue(const MPMCQueue &) = delete;
+    MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+    ~MPMCQueue()
+    {
+        // Same contract as SPSCQueue: no thread may still be using the queue
+        for (std::uint64_t pos = m_tail.load(std::memory_order_acquire),
+                           head = m_head.load(std::memory_order_acquire);
+             pos != head; ++pos)
+            std::destroy_at(p_slots[pos & kMask].ptr());
+    }
+
+    bool push(const T &x)
+    {
+        return emplace(x);
+    }
+
+    bool push(T &&x)
+    {
+        return emplace(std::move(x));
+    }
+
+    /// @brief Constructs an element in place. Any number of producer threads.
+    /// @return false if the queue is full
+    template <class... Args> bool emplace(Args &&...args)
+    {
+        std::uint64_t pos = m_head.load(std::memory_order_relaxed);
+        Slot *slot;
+        for (;;)
+        {
+            slot = &p_slots[pos & kMask];
+            // Acquire pairs with the consumer's release that freed the slot
+            const std::uint64_t seq = slot->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::int64_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0) [[unlikely]]
+                return false; // Slot still holds the element from one lap ago
+            else
+                pos = m_head.load(std::memory_order_relaxed); // Another producer won it
+        }
+
+        std::construct_at(slot->ptr(), std::forward<Args>(args)...);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Any number of consumer threads.
+    /// @return false if the queue is empty
+    bool pop(T &out)
+    {
+        return take([&out](T &&value) { out = std::move(value); });
+    }
+
+    /// @brief `pop` for element types that aren't default constructible.
+    /// @return std::nullopt if the queue is empty
+    std::optional<T> pop()
+    {
+        std::optional<T> out;
+        take([&out](T &&value) { out.emplace(std::move(value)); });
+        return out;
+    }
+
+    /// @brief Approximate under concurrency.
+    std::uint64_t size() const noexcept
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_acquire);
+        const std::uint64_t tail = m_tail.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+
+    /// @brief Approximate under concurrency.
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    static constexpr std::uint64_t capacity() noexcept
+    {
+        return kCapacity;
+    }
+};
+
+} // End namespace quick::structs
@@ -0,0 +1,134 @@
+#pragma once
+
+// C++ Includes
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// QuickLib Includes
+#include "quick/structs/SPSCQueue.hh"
+
+namespace quick::structs
+{
+
+/// @brief Link embedded in every element of an `MPSCQueue`. An element may sit
+/// in at most one queue at a time. Copies start unlinked, so elements can
+/// still live in ordinary containers.
+struct MPSCHook
+{
+    std::atomic<MPSCHook *> mpsc_next{nullptr};
+
+    MPSCHook() noexcept = default;
+    MPSCHook(const MPSCHook &) noexcept
+    {
+    }
+    MPSCHook &operator=(const MPSCHook &) noexcept
+    {
+        return *this;
+    }
+};
+
+/// @brief Unbounded intrusive multi-producer, single-consumer queue (Vyukov).
+/// The queue owns no memory: producers push pointers to elements they own
+/// (typically from a per-producer pool) and the consumer gets the same
+/// pointers back in FIFO order per producer.
+///
+/// - `push` is wait-free: one atomic exchange plus one store, whatever the
+///   other producers do.
+/// - `pop`/`drain` never lock. If a producer is preempted between its two
+///   steps, the consumer sees the queue as empty until that producer
+///   resumes, instead of waiting for it.
+/// @tparam T Element type deriving from `MPSCHook`
+template <class T> class MPSCQueue
+{
+    static_assert(std::is_base_of_v<MPSCHook, T>, "MPSCQueue elements must derive from MPSCHook");
+
+    alignas(cacheline_t::value) std::atomic<MPSCHook *> m_head; // last pushed, producers swap it
+    alignas(cacheline_t::value) MPSCHook *p_tail;                // oldest, consumer only
+    MPSCHook m_stub;                                            // keeps the list non-empty
+
+    void link(MPSCHook *node) noexcept
+    {
+        node->mpsc_next.store(nullptr, std::memory_order_relaxed);
+        MPSCHook *prev = m_head.exchange(node, std::memory_order_acq_rel);
+        // Until this store lands, the consumer can't reach `node` (or anything
+        // pushed after it)
+        prev->mpsc_next.store(node, std::memory_order_release);
+    }
+
+  public:
+    MPSCQueue() noexcept : m_head{&m_stub}, p_tail{&m_stub}
+    {
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    /// @brief Any number of producer threads. Wait-free.
+    void push(T *item) noexcept
+    {
+        link(item);
+    }
+
+    /// @brief Consumer only.
+    /// @return The oldest element, or nullptr if none is reachable yet
+    T *pop() noexcept
+    {
+        MPSCHook *tail = p_tail;
+        MPSCHook *next = tail->mpsc_next.load(std::memory_order_acquire);
+        if (tail == &m_stub)
+        {
+            if (!next)
+                return nullptr;
+            p_tail = next;
+            tail = next;
+            next = next->mpsc_next.load(std::memory_order_acquire);
+        }
+        if (next)
+        {
+            p_tail = next;
+            return static_cast<T *>(tail);
+        }
+
+        // `tail` looks like the last element. If a producer has already
+        // swapped m_head past it but not linked yet, come back later.
+        if (tail != m_head.load(std::memory_order_acquire))
+            return nullptr;
+
+        // Really the last one: park the stub behind it so it can be handed out
+        link(&m_stub);
+        next = tail->mpsc_next.load(std::memory_order_acquire);
+        if (next)
+        {
+            p_tail = next;
+            return static_cast<T *>(tail);
+        }
+        return nullptr;
+    }
+
+    /// @brief Consumer only. Hands up to `max_items` elements, oldest first,
+    /// to `fn(T*)`.
+    /// @return Number of elements drained
+    template <class Fn> std::size_t drain(Fn &&fn, std::size_t max_items = SIZE_MAX)
+    {
+        std::size_t drained = 0;
+        while (drained < max_items)
+        {
+            T *item = pop();
+            if (!item)
+                break;
+            fn(item);
+            ++drained;
+        }
+        return drained;
+    }
+
+    /// @brief Consumer only; approximate while producers are mid-push.
+    bool empty() const noexcept
+    {
+        return p_tail == &m_stub && !m_stub.mpsc_next.load(std::memory_order_acquire);
+    }
+};
+
+} // End namespace quick::structs
@@ -1,14 +1,25 @@
+#pragma once
+
+#include <x86intrin.h>
+
 #include <algorithm>
+#include <cassert>
 #include <cctype>
 #include <compare>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <iterator>
+#include <optional>
 #include <ranges>
+#include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "quick/structs/FlatHashMap.hh"
+
 using Id = size_t;
 using Price = long;
 using Quantity = int;
@@ -23,15 +34,16 @@ class Order
     };
 
   private:
+    // Widest first so the order packs into 24 bytes; the side is derived
+    // from `is_buy_` rather than stored twice
     Id id_;
     Price level_;
-    bool is_buy_;
     Quantity qty_;
-    Side side_;
+    bool is_buy_;
 
   public:
     Order(Id orderId, Price level, bool isBuy, Quantity quantity)
-        : id_{orderId}, level_{level}, is_buy_{isBuy}, qty_{quantity}, side_{isBuy ? Side::BUY : Side::SELL}
+        : id_{orderId}, level_{level}, qty_{quantity}, is_buy_{isBuy}
     {
     }
 
@@ -56,7 +68,7 @@ class Order
 
     Side get_side() const noexcept
     {
-        return side_;
+        return is_buy_ ? Side::BUY : Side::SELL;
     }
 
     Quantity get_qty() const
@@ -80,6 +92,8 @@ class Order
     }
 };
 
+static_assert(sizeof(Order) == 24, "Order should stay packed: it is what the vector book shifts and matches on");
+
 using Orders = std::vector<Order>;
 
 // DO NOT MODIFY.
@@ -95,10 +109,185 @@ struct Trade
 
 using Trades = std::vector<Trade>;
 
+/// @brief Receives fills as they happen, e.g. a lambda, a `TradeBuffer` or a
+/// `QueueTradeSink`. Used by the allocation-free `AddOrder` overloads.
+template <class Sink>
+concept TradeSink = std::invocable<Sink &, const Trade &>;
+
+/// @brief Trade sink writing into caller-owned storage (a fixed array, a
+/// reused vector, ...).
+/// @attention The storage must hold every fill written between two
+/// `clear()`s, e.g. one per resting order an aggressor can sweep; a fill
+/// past the end is a contract violation, not a drop
+struct TradeBuffer
+{
+    std::span<Trade> storage;
+    std::size_t count{0};
+
+    void operator()(const Trade &trade) noexcept
+    {
+        assert(count < storage.size() && "TradeBuffer too small for this sweep");
+        storage[count++] = trade;
+    }
+
+    std::span<const Trade> trades() const noexcept
+    {
+        return storage.first(count);
+    }
+
+    void clear() noexcept
+    {
+        count = 0;
+    }
+};
+
+/// @brief Trade sink publishing to a bounded queue such as
+/// `quick::structs::SPSCQueue<Trade, N>`. No fill is ever lost: while the
+/// queue is full the matcher spins until the consumer makes room, so size
+/// the queue for the bursts you expect and keep the consumer running.
+template <class Queue> struct QueueTradeSink
+{
+    Queue &queue;
+
+    void operator()(const Trade &trade)
+    {
+        while (!queue.push(trade)) [[unlikely]]
+            _mm_pause();
+    }
+};
+
+/// @brief Anything that can stand in for `Orderbook` behind the
+/// `AddOrder`/`CancelOrder` API (see `LadderOrderbook`).
+template <class Book>
+concept OrderbookEngine = requires(Book &book, const Order &order, Id id, TradeBuffer &sink) {
+    { book.AddOrder(order) } -> std::same_as<Trades>;
+    { book.AddOrder(order, sink) } -> std::same_as<std::size_t>;
+    book.CancelOrder(id);
+    book.ReduceOrder(id, Quantity{});
+    { book.ModifyOrder(id, Price{}, Quantity{}, sink) } -> std::same_as<std::size_t>;
+    { book.best_bid() } -> std::same_as<std::optional<Price>>;
+    { book.best_ask() } -> std::same_as<std::optional<Price>>;
+};
+
+/// @brief One aggregated row of L2 depth.
+struct DepthLevel
+{
+    Price level;
+    std::int64_t qty;
+    std::uint32_t orders;
+};
+
+/// @brief Incremental L2 change for one level; `depth.orders == 0` means the
+/// level is gone.
+struct DepthUpdate
+{
+    bool is_buy;
+    DepthLevel depth;
+};
+
+/// @brief Flat, trivially copyable order-entry message, so commands can cross
+/// threads through lock-free queues or be replayed from contiguous buffers.
+struct OrderCommand
+{
+    enum class Type : std::uint8_t
+    {
+        ADD,
+        CANCEL,
+        REDUCE, // `qty` is the amount to take off
+        MODIFY  // `level`/`qty` are the new price and size
+    };
+
+    Type type{Type::ADD};
+    bool is_buy{false};
+    Quantity qty{0};
+    Id id{0};
+    Price level{0};
+
+    static OrderCommand add(const Order &order) noexcept
+    {
+        return OrderCommand{Type::ADD, order.is_buy(), order.get_qty(), order.get_id(), order.get_level()};
+    }
+
+    static OrderCommand cancel(Id order_id) noexcept
+    {
+        return OrderCommand{Type::CANCEL, false, 0, order_id, 0};
+    }
+
+    /// @param reduce_by Positive; books ignore anything else
+    static OrderCommand reduce(Id order_id, Quantity reduce_by) noexcept
+    {
+        assert(reduce_by > 0);
+        return OrderCommand{Type::REDUCE, false, reduce_by, order_id, 0};
+    }
+
+    static OrderCommand modify(Id order_id, Price new_level, Quantity new_qty) noexcept
+    {
+        return OrderCommand{Type::MODIFY, false, new_qty, order_id, new_level};
+    }
+
+    Order to_order() const noexcept
+    {
+        return Order{id, level, is_buy, qty};
+    }
+};
+
+/// @brief Applies one command to any `OrderbookEngine`, sending fills to `sink`.
+/// @return Number of trades emitted
+template <OrderbookEngine Book, TradeSink Sink>
+std::size_t ApplyCommand(Book &book, const OrderCommand &command, Sink &&sink)
+{
+    switch (command.type)
+    {
+    case OrderCommand::Type::ADD:
+        return book.AddOrder(command.to_order(), sink);
+    case OrderCommand::Type::CANCEL:
+        book.CancelOrder(command.id);
+        return 0;
+    case OrderCommand::Type::REDUCE:
+        book.ReduceOrder(command.id, command.qty);
+        return 0;
+    case OrderCommand::Type::MODIFY:
+        return book.ModifyOrder(command.id, command.level, command.qty, sink);
+    }
+    return 0;
+}
+
+/// @brief Applies `commands` in order, appending every fill to `out`.
+/// Produces exactly the trades of the equivalent sequence of single calls,
+/// but makes room in `out` up front and uses the book's own `ApplyBatch`
+/// (e.g. with index prefetching) when it has one.
+/// @return Number of trades appended
+template <OrderbookEngine Book> std::size_t ApplyBatch(Book &book, std::span<const OrderCommand> commands, Trades &out)
+{
+    // Grow geometrically: an exact reserve on every call into the same `out`
+    // would reallocate each time, quadratic over a stream of batches
+    const std::size_t needed = out.size() + commands.size();
+    if (out.capacity() < needed)
+        out.reserve(std::max(2 * out.capacity(), needed));
+    auto sink = [&out](const Trade &trade) { out.push_back(trade); };
+    if constexpr (requires { book.ApplyBatch(commands, sink); })
+        return book.ApplyBatch(commands, sink);
+    else
+    {
+        std::size_t n_trades = 0;
+        for (const OrderCommand &command : commands)
+            n_trades += ApplyCommand(book, command, sink);
+        return n_trades;
+    }
+}
+
 class Orderbook
 {
+    // Where a resting order sits, so dedupe/cancel don't have to scan
+    struct OrderLocation
+    {
+        Price level;
+        bool is_buy;
+    };
+
     Orders bids_{};
     Orders asks_{};
+    quick::structs::FlatHashMap<Id, OrderLocation> index_{};
 
   public:
     static constexpr inline std::uint64_t reserved_size_ = 20UL;
@@ -107,6 +296,7 @@ class Orderbook
     {
         bids_.reserve(reserved_size_);
         asks_.reserve(reserved_size_);
+        index_.reserve(2 * reserved_size_);
     }
 
     bool can_match(const Order &buy, const Order &sell)
@@ -114,16 +304,28 @@ class Orderbook
         return (buy.get_level() >= sell.get_level());
     }
 
-    bool is_dupe(const Order &order)
+    std::optional<Price> best_bid() const noexcept
+    {
+        if (bids_.empty())
+            return std::nullopt;
+        return bids_.back().get_level();
+    }
+
+    std::optional<Price> best_ask() const noexcept
     {
-        auto is_match = [&order](Order &o) { return (o.get_id() == order.get_id()); };
+        if (asks_.empty())
+            return std::nullopt;
+        return asks_.back().get_level();
+    }
 
-        return std::ranges::any_of(bids_, is_match) || std::ranges::any_of(asks_, is_match);
+    bool is_dupe(const Order &order) const noexcept
+    {
+        return index_.contains(order.get_id());
     }
 
     void insert_order(const Order &order)
     {
-        if (is_dupe(order))
+        if (!index_.insert(order.get_id(), OrderLocation{order.get_level(), order.is_buy()}))
             return;
         if (order.is_buy())
         {
@@ -142,8 +344,18 @@ class Orderbook
     Trades AddOrder(const Order &incoming)
     {
         Trades trades;
+        AddOrder(incoming, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Same matching as `AddOrder(incoming)`, but fills go straight to
+    /// `sink` instead of a freshly allocated `Trades`.
+    /// @return Number of trades emitted
+    template <TradeSink Sink> std::size_t AddOrder(const Order &incoming, Sink &&sink)
+    {
+        std::size_t n_trades = 0;
         if (is_dupe(incoming))
-            return trades;
+            return n_trades;
 
         auto &opposite_side = incoming.is_buy() ? asks_ : bids_;
         // auto& same_side     = incoming.is_buy() ? bids_ : asks_;
@@ -175,8 +387,8 @@ class Orderbook
             Id ask_order_id = incoming.is_buy() ? best.get_id() : incoming.get_id();
 
             // send trade since there is a match
-            trades.emplace_back(
-                Trade{bid_order_id, ask_order_id, aggressor_id, aggressor_is_buy, trade_price, trade_size});
+            sink(Trade{bid_order_id, ask_order_id, aggressor_id, aggressor_is_buy, trade_price, trade_size});
+            ++n_trades;
 
             // update quantities
             best.set_qty(best.get_qty() - trade_size);
@@ -184,7 +396,10 @@ class Orderbook
 
             // get rid of fully-filled opposite-side order (remove last element)
             if (best.get_qty() == 0)
+            {
+                index_.erase(best.get_id());
                 opposite_side.pop_back();
+            }
         }
 
         if (remaining > 0)
@@ -193,23 +408,107 @@ class Orderbook
             corrected_incoming.set_qty(remaining);
             insert_order(corrected_incoming);
         }
-        return trades;
+        return n_trades;
     }
 
     void CancelOrder(Id order_id)
     {
-        auto id_match = [=](const Order &o) { return o.get_id() == order_id; };
-        auto bid_it = std::ranges::find_if(bids_, id_match);
-        if (bid_it != std::end(bids_))
+        auto it = find_resting(order_id);
+        if (!it)
+            return;
+        auto &[side, pos] = *it;
+        side->erase(pos);
+        index_.erase(order_id);
+    }
+
+    /// @brief Takes `reduce_by` off a resting order without losing its place
+    /// in the queue. Reducing to zero or below cancels it; a non-positive
+    /// `reduce_by` (which would grow the order in place) is ignored.
+    void ReduceOrder(Id order_id, Quantity reduce_by)
+    {
+        if (reduce_by <= 0) [[unlikely]]
+            return;
+        auto it = find_resting(order_id);
+        if (!it)
+            return;
+        auto &[side, pos] = *it;
+        if (pos->get_qty() <= reduce_by)
         {
-            bids_.erase(bid_it);
+            side->erase(pos);
+            index_.erase(order_id);
             return;
         }
-        auto asks_it = std::ranges::find_if(asks_, id_match);
-        if (asks_it != std::end(asks_))
+        pos->set_qty(pos->get_qty() - reduce_by);
+    }
+
+    [[nodiscard]]
+    Trades ModifyOrder(Id order_id, Price new_level, Quantity new_qty)
+    {
+        Trades trades;
+        ModifyOrder(order_id, new_level, new_qty, [&trades](const Trade &trade) { trades.push_back(trade); });
+        return trades;
+    }
+
+    /// @brief Changes a resting order's price and/or size. A pure size
+    /// decrease keeps its queue position (see `ReduceOrder`); a price change
+    /// or size increase requeues it at the back of its new level, where it
+    /// may trade like a fresh `AddOrder`. Unknown ids are ignored.
+    /// @return Number of trades emitted
+    template <TradeSink Sink> std::size_t ModifyOrder(Id order_id, Price new_level, Quantity new_qty, Sink &&sink)
+    {
+        auto it = find_resting(order_id);
+        if (!it)
+            return 0;
+        auto &[side, pos] = *it;
+        if (new_level == pos->get_level() && new_qty <= pos->get_qty())
         {
-            asks_.erase(asks_it);
-            return;
+            ReduceOrder(order_id, pos->get_qty() - new_qty);
+            return 0;
         }
+        const bool is_buy = pos->is_buy();
+        side->erase(pos);
+        index_.erase(order_id);
+        return AddOrder(Order{order_id, new_level, is_buy, new_qty}, sink);
+    }
+
+    /// @brief Aggregated (level, total size, order count) rows for one side,
+    /// best first, into `out`. O(resting orders) for this book.
+    /// @return Number of levels written
+    std::size_t DepthSnapshot(bool is_buy, std::span<DepthLevel> out) const noexcept
+    {
+        const Orders &side = is_buy ? bids_ : asks_;
+        std::size_t n = 0;
+        for (auto it = side.rbegin(); it != side.rend(); ++it)
+        {
+            if (n > 0 && out[n - 1].level == it->get_level())
+            {
+                out[n - 1].qty += it->get_qty();
+                ++out[n - 1].orders;
+                continue;
+            }
+            if (n == out.size())
+                break;
+            out[n++] = DepthLevel{it->get_level(), it->get_qty(), 1U};
+        }
+        return n;
+    }
+
+  private:
+    // Index lookup, then a binary search down to the order's price level
+    std::optional<std::pair<Orders *, Orders::iterator>> find_resting(Id order_id)
+    {
+        const OrderLocation *loc = index_.find(order_id);
+        if (!loc)
+            return std::nullopt;
+        auto id_match = [=](const Order &o) { return o.get_id() == order_id; };
+        Orders &side = loc->is_buy ? bids_ : asks_;
+        auto level = loc->is_buy
+                         ? std::ranges::equal_range(side, loc->level, std::less<Price>(), &Order::get_level)
+                         : std::ranges::equal_range(side, loc->level, std::greater<Price>(), &Order::get_level);
+        auto pos = std::ranges::find_if(level, id_match);
+        assert(pos != level.end());
+        return std::pair{&side, pos};
     }
 };
+
+static_assert(OrderbookEngine<Orderbook>);
@@ -0,0 +1,249 @@
+#pragma once
+
+// C++ Includes
+#include <x86intrin.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// QuickLib Includes
+#include "quick/structs/FlatHashMap.hh"
+#include "quick/structs/LadderOrderbook.hh"
+#include "quick/structs/Orderbook.hh"
+#include "quick/structs/SPSCQueue.hh"
+#include "quick/thread/Affinity.hpp"
+
+namespace quick::structs
+{
+
+using InstrumentId = std::uint32_t;
+
+struct InstrumentCommand
+{
+    InstrumentId instrument{0};
+    OrderCommand command{};
+};
+
+struct InstrumentTrade
+{
+    InstrumentId instrument{0};
+    Trade trade{};
+};
+
+/// @brief Owns one order book per instrument and shards the instruments
+/// across worker threads, one shard per thread.
+/// Commands reach a shard through its own `SPSCQueue` and fills come back
+/// through another, so no lock is taken anywhere and each book is only ever
+/// touched by the thread that owns it. Matching throughput scales with the
+/// number of shards as long as flow is spread across instruments.
+///
+/// Threading contract:
+/// - `add_instrument` before `start()`, from the thread that will route.
+/// - `submit` from ONE router thread (it is the producer of every inbound
+///   queue).
+/// - `poll_trades` from ONE consumer thread (the consumer of every outbound
+///   queue).
+/// - After `stop()`, `poll_trades` until it returns 0 before `start()`ing
+///   again.
+/// @tparam Book Any `OrderbookEngine`
+/// @tparam QueueDepth Per-shard inbound/outbound queue capacity (power of two)
+template <OrderbookEngine Book = LadderOrderbook, std::uint64_t QueueDepth = (1UL << 14)> class OrderbookManager
+{
+    struct Shard
+    {
+        SPSCQueue<InstrumentCommand, QueueDepth> inbound;
+        SPSCQueue<InstrumentTrade, QueueDepth> outbound;
+        FlatHashMap<InstrumentId, Book *> books;
+        std::vector<std::unique_ptr<Book>> storage;
+        alignas(cacheline_t::value) std::atomic<std::uint64_t> processed{0};
+        std::atomic<bool> exited{false};
+        std::vector<InstrumentTrade> overflow; // worker-owned until `exited`
+        std::jthread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    FlatHashMap<InstrumentId, std::uint32_t> m_routes;
+    std::vector<int> m_cpus;
+    bool m_running{false};
+
+    static void run(Shard &shard, std::stop_token stoken)
+    {
+        InstrumentCommand routed;
+        for (;;)
+        {
+            // Read the stop flag BEFORE popping: a stop requested after the
+            // router's last submit then guarantees we see that submit too
+            const bool stopping = stoken.stop_requested();
+            if (!shard.inbound.pop(routed))
+            {
+                if (stopping)
+                {
+                    shard.exited.store(true, std::memory_order_release);
+                    return;
+                }
+                _mm_pause();
+                continue;
+            }
+
+            Book *book = *shard.books.find(routed.instrument);
+            ApplyCommand(*book, routed.command, [&](const Trade &trade) {
+                // Backpressure on a slow trade consumer. Once stopping, park
+                // what no longer fits so shutdown never hangs on a consumer
+                // that only polls after stop(); poll_trades hands it out
+                const InstrumentTrade fill{routed.instrument, trade};
+                while (!shard.overflow.empty() || !shard.outbound.push(fill))
+                {
+                    if (stoken.stop_requested()) [[unlikely]]
+                    {
+                        shard.overflow.push_back(fill);
+                        return;
+                    }
+                    _mm_pause();
+                }
+            });
+            shard.processed.store(shard.processed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    }
+
+  public:
+    /// @param num_shards Number of worker threads
+    /// @param cpus Optional CPU per shard (`cpus[i % cpus.size()]` for shard i)
+    explicit OrderbookManager(std::size_t num_shards, std::vector<int> cpus = {}) : m_cpus{std::move(cpus)}
+    {
+        assert(num_shards > 0);
+        m_shards.reserve(num_shards);
+        for (std::size_t i = 0; i < num_shards; ++i)
+            m_shards.push_back(std::make_unique<Shard>());
+    }
+
+    OrderbookManager(const OrderbookManager &) = delete;
+    OrderbookManager &operator=(const OrderbookManager &) = delete;
+
+    ~OrderbookManager()
+    {
+        stop();
+    }
+
+    std::size_t num_shards() const noexcept
+    {
+        return m_shards.size();
+    }
+
+    /// @brief Registers `instrument` on shard `instrument % num_shards()`,
+    /// constructing its book from `book_args`.
+    /// @return false if the instrument exists or the workers are running
+    template <class... BookArgs> bool add_instrument(InstrumentId instrument, BookArgs &&...book_args)
+    {
+        return add_instrument_to_shard(instrument, instrument % m_shards.size(),
+                                       std::forward<BookArgs>(book_args)...);
+    }
+
+    /// @brief Same as `add_instrument`, with explicit placement (e.g. to keep
+    /// the busiest symbols apart).
+    template <class... BookArgs>
+    bool add_instrument_to_shard(InstrumentId instrument, std::size_t shard_idx, BookArgs &&...book_args)
+    {
+        assert(shard_idx < m_shards.size());
+        if (m_running || m_routes.contains(instrument))
+            return false;
+        Shard &shard = *m_shards[shard_idx];
+        shard.storage.push_back(std::make_unique<Book>(std::forward<BookArgs>(book_args)...));
+        shard.books.insert(instrument, shard.storage.back().get());
+        m_routes.insert(instrument, static_cast<std::uint32_t>(shard_idx));
+        return true;
+    }
+
+    std::optional<std::size_t> shard_of(InstrumentId instrument) const noexcept
+    {
+        const std::uint32_t *shard_idx = m_routes.find(instrument);
+        if (!shard_idx)
+            return std::nullopt;
+        return *shard_idx;
+    }
+
+    /// @brief Spawns (and optionally pins) one worker per shard.
+    void start()
+    {
+        if (m_running)
+            return;
+        m_running = true;
+        for (std::size_t i = 0; i < m_shards.size(); ++i)
+        {
+            Shard &shard = *m_shards[i];
+            assert(shard.overflow.empty() && "poll_trades() the previous run's fills first");
+            shard.exited.store(false, std::memory_order_relaxed);
+            shard.worker = std::jthread{[&shard](std::stop_token stoken) { run(shard, stoken); }};
+            quick::thread::name_thread(shard.worker.native_handle(), std::format("quick-book-{}", i));
+            if (!m_cpus.empty())
+                quick::thread::pin_thread(shard.worker.native_handle(), m_cpus[i % m_cpus.size()]);
+        }
+    }
+
+    /// @brief Lets every worker drain its inbound queue, then joins it. Call
+    /// from the router thread after its last `submit`. No fill is lost: those
+    /// that did not fit an outbound queue are kept for `poll_trades`.
+    void stop()
+    {
+        if (!m_running)
+            return;
+        for (auto &shard : m_shards)
+            shard->worker.request_stop();
+        for (auto &shard : m_shards)
+            shard->worker.join();
+        m_running = false;
+    }
+
+    /// @brief Routes a command to the shard owning `instrument`.
+    /// @return false if the instrument is unknown or its shard's queue is
+    ///         full (retry later)
+    bool submit(InstrumentId instrument, const OrderCommand &command)
+    {
+        const std::uint32_t *shard_idx = m_routes.find(instrument);
+        if (!shard_idx) [[unlikely]]
+            return false;
+        return m_shards[*shard_idx]->inbound.push(InstrumentCommand{instrument, command});
+    }
+
+    /// @brief Hands every fill published so far to `fn(const InstrumentTrade&)`,
+    /// in per-instrument match order.
+    /// @return Number of fills drained
+    template <class Fn> std::size_t poll_trades(Fn &&fn)
+    {
+        std::size_t drained = 0;
+        InstrumentTrade fill;
+        for (auto &shard : m_shards)
+        {
+            // Checked first: once the worker has exited, the queue drained
+            // below holds its last fills and the overflow follows them
+            const bool exited = shard->exited.load(std::memory_order_acquire);
+            while (shard->outbound.pop(fill))
+            {
+                fn(std::as_const(fill));
+                ++drained;
+            }
+            if (!exited)
+                continue;
+            for (const InstrumentTrade &parked : shard->overflow)
+                fn(parked);
+            drained += shard->overflow.size();
+            shard->overflow.clear();
+        }
+        return drained;
+    }
+
+    /// @brief Commands fully applied by shard `shard_idx` so far.
+    std::uint64_t processed(std::size_t shard_idx) const noexcept
+    {
+        return m_shards[shard_idx]->processed.load(std::memory_order_acquire);
+    }
+};
+
+} // End namespace quick::structs
@@ -3,15 +3,23 @@
 // C++ Includes
 #include <x86intrin.h>
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <new>
+#include <span>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
 // QuickLib Includes
+#include "quick/memory/HugePageRegion.hh"
 
 namespace quick::structs
 {
@@ -23,6 +31,62 @@ constexpr std::uint16_t CACHE_LINE_SIZE_BYTES{64};
 using cacheline_t = std::integral_constant<std::uint64_t, CACHE_LINE_SIZE_BYTES>;
 #endif
 
+/// @brief Pass as `SPSCQueue`'s capacity to size the ring at construction
+/// instead (heap/huge-page backed, see `HugePageRegion`).
+inline constexpr std::uint64_t dynamic_capacity = 0;
+
+namespace detail
+{
+// Ring embedded in the queue object; capacity and mask are compile-time
+template <class T, std::uint64_t Capacity> struct InlineRing
+{
+    // Ensure storage is aligned both to cache-line boundaries (for
+    // padding/padding avoidance) and to the element alignment so placement-new
+    // on T is safe.
+    alignas(cacheline_t::value) alignas(alignof(T)) std::byte m_storage[Capacity * sizeof(T)];
+
+    static constexpr std::uint64_t capacity() noexcept
+    {
+        return Capacity;
+    }
+    static constexpr std::uint64_t mask() noexcept
+    {
+        return Capacity - 1;
+    }
+    std::byte *data() noexcept
+    {
+        return m_storage;
+    }
+};
+
+// Ring in its own (optionally huge-page) mapping, sized at runtime
+template <class T> struct MappedRing
+{
+    static_assert(alignof(T) <= 4096, "MappedRing storage is only page aligned");
+
+    quick::memory::HugePageRegion m_region;
+    std::uint64_t m_capacity;
+
+    MappedRing(std::uint64_t capacity, quick::memory::HugePages pages)
+        : m_region{capacity * sizeof(T), pages}, m_capacity{capacity}
+    {
+    }
+
+    std::uint64_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+    std::uint64_t mask() const noexcept
+    {
+        return m_capacity - 1;
+    }
+    std::byte *data() noexcept
+    {
+        return m_region.data();
+    }
+};
+} // namespace detail
+
 /// @brief  Lock free single-producer, single-consumer queue (constexpr
 /// constructed)
 /// @attention Not liable for damages if you have more than ONE
@@ -30,9 +94,12 @@ using cacheline_t = std::integral_constant<std::uint64_t, CACHE_LINE_SIZE_BYTES>
 ///            pair of threads accessing this queue. Undefined behavior, data
 ///            races, all the good things...
 /// @tparam T No array types pls
-/// @tparam CapacityPow2 Capacity should be power of two for logical indexing
+/// @tparam CapacityPow2 Capacity should be power of two for logical indexing.
+///         `dynamic_capacity` takes it from the constructor instead and maps
+///         the ring separately (so big queues don't live on the stack or in
+///         the owning object, and can use huge pages).
 ///
-/// @todo I should make it so that old values are overwritten
+/// @see LossySPSCQueue for an overwrite-oldest variant
 /// @todo Maintain pointers (handles) to preallocated buckets for
 /// pre-constructed
 ///       slots (instead of doing malloc and placement new on every push).
@@ -41,25 +108,86 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
 {
     static_assert(!std::is_array_v<T>, "SPSCQueue does not support array element types");
     static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
-    static constexpr std::uint64_t kCapacity = CapacityPow2;
-    static constexpr std::uint64_t kMask = kCapacity - 1;
+    static constexpr bool kDynamic = CapacityPow2 == dynamic_capacity;
+    using Ring = std::conditional_t<kDynamic, detail::MappedRing<T>, detail::InlineRing<T, CapacityPow2>>;
 
+    // Each side keeps a private copy of the other side's index next to its own
+    // and only re-reads the shared one when the copy says full/empty, so the
+    // steady state touches no cache line the other core is writing.
     alignas(cacheline_t::value) std::atomic<std::uint64_t> m_head{0}; // written by producer, read by consumer
+    std::uint64_t m_tail_cache{0};                                    // producer's view of m_tail
+    bool m_reserved{false};                                           // producer holds an uncommitted slot
     alignas(cacheline_t::value) std::atomic<std::uint64_t> m_tail{0}; // written by consumer, read by producer
+    std::uint64_t m_head_cache{0};                                    // consumer's view of m_head
 
-    // Ensure storage is aligned both to cache-line boundaries (for
-    // padding/padding avoidance) and to the element alignment so placement-new
-    // on T is safe.
-    alignas(cacheline_t::value) alignas(alignof(T)) std::byte m_storage[kCapacity * sizeof(T)];
+    alignas(cacheline_t::value) Ring m_ring;
 
     // Helpers to index into ring without branching
-    static T *slot_ptr(std::byte *base, std::uint64_t idx) noexcept
+    T *slot_ptr(std::uint64_t idx) noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(m_ring.data() + (idx & m_ring.mask()) * sizeof(T)));
+    }
+
+    // Producer side: free slots ahead of `head`, refreshing the cached tail
+    // only if it can't already cover `wanted`
+    std::uint64_t free_slots(std::uint64_t head, std::uint64_t wanted) noexcept
     {
-        return std::launder(reinterpret_cast<T *>(base + (idx & kMask) * sizeof(T)));
+        std::uint64_t free = m_ring.capacity() - (head - m_tail_cache);
+        if (free < wanted)
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            free = m_ring.capacity() - (head - m_tail_cache);
+        }
+        return free;
+    }
+
+    // Consumer side: published slots from `tail`, same refresh rule
+    std::uint64_t ready_slots(std::uint64_t tail, std::uint64_t wanted) noexcept
+    {
+        std::uint64_t ready = m_head_cache - tail;
+        if (ready < wanted)
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            ready = m_head_cache - tail;
+        }
+        return ready;
+    }
+
+    // Dynamic capacity: `capacity` rounded up to a power of two, as long as
+    // the ring's byte size still fits
+    static std::uint64_t ring_capacity(std::uint64_t capacity)
+    {
+        constexpr std::uint64_t kMax = std::bit_floor(std::numeric_limits<std::uint64_t>::max() / sizeof(T));
+        if (capacity > kMax)
+            throw std::length_error{"SPSCQueue: ring size overflows"};
+        return std::bit_ceil(std::max<std::uint64_t>(capacity, 1));
     }
 
   public:
-    constexpr SPSCQueue() = default;
+    constexpr SPSCQueue()
+        requires(!kDynamic)
+    = default;
+
+    /// @brief Runtime-capacity queue (`SPSCQueue<T, dynamic_capacity>`).
+    /// Rings of at least one huge page get transparent huge pages, smaller
+    /// ones plain pages (a THP mapping takes 2 MiB however small the ring).
+    /// @param capacity Rounded up to a power of two
+    /// @throws std::length_error if the ring's size in bytes overflows
+    explicit SPSCQueue(std::uint64_t capacity)
+        requires kDynamic
+        : SPSCQueue{capacity, ring_capacity(capacity) * sizeof(T) >= quick::memory::HugePageRegion::kHugePageSize
+                                  ? quick::memory::HugePages::TRANSPARENT
+                                  : quick::memory::HugePages::NONE}
+    {
+    }
+
+    /// @param pages Backing for the ring; it is prefaulted either way
+    SPSCQueue(std::uint64_t capacity, quick::memory::HugePages pages)
+        requires kDynamic
+        : m_ring{ring_capacity(capacity), pages}
+    {
+    }
+
     SPSCQueue(const SPSCQueue &) = delete;
     SPSCQueue &operator=(const SPSCQueue &) = delete;
 
@@ -74,9 +202,11 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
         auto head = m_head.load(std::memory_order_acquire);
         while (tail != head)
         {
-            std::destroy_at(slot_ptr(m_storage, tail));
+            std::destroy_at(slot_ptr(tail));
             ++tail;
         }
+        if (m_reserved)
+            std::destroy_at(slot_ptr(head));
     }
 
     /// @brief Copy push. Try moving instead of you can. Calls `emplace(arg)`.
@@ -106,16 +236,20 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     /// @return Success or failure as a bool.
     template <class... Args> bool emplace(Args &&...args)
     {
+        assert(!m_reserved && "emplace() between reserve() and commit()");
         // Producer thread only mutates m_head
         std::uint64_t head = m_head.load(std::memory_order_relaxed);
-        // Read consumer's tail with acquire to observe element reclamation
-        std::uint64_t tail = m_tail.load(std::memory_order_acquire);
 
-        // Full if producer is kCapacity ahead of consumer
-        if ((head - tail) == kCapacity) [[unlikely]]
-            return false;
+        // Full if producer is a whole ring ahead of consumer. Only then refresh
+        // the cached tail, with acquire to observe element reclamation
+        if ((head - m_tail_cache) == m_ring.capacity()) [[unlikely]]
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if ((head - m_tail_cache) == m_ring.capacity())
+                return false;
+        }
 
-        T *p = slot_ptr(m_storage, head);
+        T *p = slot_ptr(head);
         std::construct_at(p, std::forward<Args>(args)...);
 
         // Publish the new element: release pairs with consumer's acquire
@@ -128,13 +262,17 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     {
         // Consumer thread only mutates m_tail
         std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
-        // Read producer's head with acquire to observe the constructed element
-        std::uint64_t head = m_head.load(std::memory_order_acquire);
 
-        if (head == tail) [[unlikely]]
-            return false; // empty
+        // Empty according to the cached head: refresh it, with acquire to
+        // observe the constructed element
+        if (m_head_cache == tail) [[unlikely]]
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if (m_head_cache == tail)
+                return false; // empty
+        }
 
-        T *p = slot_ptr(m_storage, tail);
+        T *p = slot_ptr(tail);
         out = std::move(*p);
         std::destroy_at(p);
 
@@ -143,6 +281,128 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
         return true;
     }
 
+    /// @brief Copies as many of `items` as fit, then publishes them all with
+    /// one release store. Trivially copyable `T` is moved with at most two
+    /// `memcpy`s (one per side of the wraparound).
+    /// @return Number of elements pushed (a prefix of `items`)
+    std::uint64_t push_bulk(std::span<const T> items)
+    {
+        assert(!m_reserved && "push_bulk() between reserve() and commit()");
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        const std::uint64_t n = std::min<std::uint64_t>(items.size(), free_slots(head, items.size()));
+        if (n == 0)
+            return 0;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            const std::uint64_t first = std::min(n, m_ring.capacity() - (head & m_ring.mask()));
+            std::memcpy(m_ring.data() + (head & m_ring.mask()) * sizeof(T), items.data(), first * sizeof(T));
+            std::memcpy(m_ring.data(), items.data() + first, (n - first) * sizeof(T));
+        }
+        else
+        {
+            for (std::uint64_t i = 0; i < n; ++i)
+                std::construct_at(slot_ptr(head + i), items[i]);
+        }
+
+        m_head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /// @brief All-or-nothing: constructs `n` elements from `make(i)`
+    /// (i = 0..n-1) in place and publishes them with one release store.
+    /// @return false (and constructs nothing) if fewer than `n` slots are free
+    template <class Make> bool try_emplace_n(std::uint64_t n, Make &&make)
+    {
+        assert(!m_reserved && "try_emplace_n() between reserve() and commit()");
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (free_slots(head, n) < n)
+            return false;
+        for (std::uint64_t i = 0; i < n; ++i)
+            std::construct_at(slot_ptr(head + i), make(i));
+        m_head.store(head + n, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Moves up to `out.size()` elements out, then frees their slots
+    /// with one release store. Trivially copyable `T` is copied with at most
+    /// two `memcpy`s.
+    /// @return Number of elements written to the front of `out`
+    std::uint64_t pop_bulk(std::span<T> out)
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::uint64_t n = std::min<std::uint64_t>(out.size(), ready_slots(tail, out.size()));
+        if (n == 0)
+            return 0;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            const std::uint64_t first = std::min(n, m_ring.capacity() - (tail & m_ring.mask()));
+            std::memcpy(out.data(), m_ring.data() + (tail & m_ring.mask()) * sizeof(T), first * sizeof(T));
+            std::memcpy(out.data() + first, m_ring.data(), (n - first) * sizeof(T));
+        }
+        else
+        {
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                T *p = slot_ptr(tail + i);
+                out[i] = std::move(*p);
+                std::destroy_at(p);
+            }
+        }
+
+        m_tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /// @brief Zero-copy produce, step 1: default-initializes the next slot
+    /// (a no-op for trivially default constructible `T`, whose fields keep
+    /// whatever the slot last held) and hands it out so the caller can fill
+    /// it in place, e.g. parse a packet straight into it. Calling again
+    /// before `commit()` returns the same slot.
+    /// @return The slot, or nullptr if the queue is full
+    T *reserve()
+    {
+        const std::uint64_t head = m_head.load(std::memory_order_relaxed);
+        T *p = slot_ptr(head);
+        if (m_reserved)
+            return p;
+        if (free_slots(head, 1) == 0)
+            return nullptr;
+        ::new (static_cast<void *>(p)) T;
+        m_reserved = true;
+        return p;
+    }
+
+    /// @brief Zero-copy produce, step 2: publishes the slot from `reserve()`.
+    void commit() noexcept
+    {
+        assert(m_reserved && "commit() without reserve()");
+        m_reserved = false;
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// @brief Zero-copy consume, step 1: the oldest element, in place. Stays
+    /// valid (and owned by the queue) until `consume()`.
+    /// @return The element, or nullptr if the queue is empty
+    T *front() noexcept
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (ready_slots(tail, 1) == 0)
+            return nullptr;
+        return slot_ptr(tail);
+    }
+
+    /// @brief Zero-copy consume, step 2: destroys the element returned by
+    /// `front()` and frees its slot. Requires a non-null `front()` first.
+    void consume() noexcept
+    {
+        const std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        assert(m_head_cache != tail && "consume() on an empty queue");
+        std::destroy_at(slot_ptr(tail));
+        m_tail.store(tail + 1, std::memory_order_release);
+    }
+
     bool empty() const noexcept
     {
         // Acquire not strictly required here for SPSC fast-path introspection,
@@ -156,7 +416,7 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     {
         auto head = m_head.load(std::memory_order_relaxed);
         auto tail = m_tail.load(std::memory_order_acquire);
-        return (head - tail) == kCapacity;
+        return (head - tail) == m_ring.capacity();
     }
 
     std::uint64_t size() const noexcept
@@ -167,8 +427,22 @@ template <class T, std::uint64_t CapacityPow2> class SPSCQueue
     }
 
     static constexpr std::uint64_t capacity() noexcept
+        requires(!kDynamic)
+    {
+        return CapacityPow2;
+    }
+
+    std::uint64_t capacity() const noexcept
+        requires kDynamic
+    {
+        return m_ring.capacity();
+    }
+
+    /// @brief What the ring's mapping actually got (dynamic capacity only).
+    quick::memory::PageBacking page_backing() const noexcept
+        requires kDynamic
     {
-        return kCapacity;
+        return m_ring.m_region.backing();
     }
 };
 /// @example spsc_queue_example.cc
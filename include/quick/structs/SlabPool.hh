@@ -0,0 +1,103 @@
+#pragma once
+
+// C++ Includes
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace quick::structs
+{
+
+/// @brief Fixed-capacity object pool addressed by 32-bit handles.
+/// All storage (slots plus the free-list stack) is allocated and pre-faulted
+/// in the constructor; `emplace`/`release` are O(1) and never touch the
+/// global allocator afterwards. Handles rather than pointers keep intrusive
+/// links (prev/next) at 4 bytes each.
+/// @tparam T Trivially destructible element type, so the pool never has to
+///           track which slots are live on destruction
+template <class T> class SlabPool
+{
+    static_assert(std::is_trivially_destructible_v<T>, "SlabPool only holds trivially destructible types");
+
+  public:
+    using Handle = std::uint32_t;
+    static constexpr Handle npos = std::numeric_limits<Handle>::max();
+
+  private:
+    std::allocator<T> m_alloc{};
+    T *p_slots{nullptr};
+    std::uint32_t m_capacity{0};
+    std::vector<Handle> m_free; // LIFO so recently released (cache-warm) slots are reused first
+
+  public:
+    explicit SlabPool(std::uint32_t capacity) : m_capacity{capacity}
+    {
+        assert(capacity < npos);
+        p_slots = m_alloc.allocate(capacity);
+        // Touch every page now rather than on the first burst of inserts
+        std::memset(static_cast<void *>(p_slots), 0, sizeof(T) * capacity);
+        m_free.reserve(capacity);
+        for (Handle h = capacity; h > 0; --h)
+            m_free.push_back(h - 1);
+    }
+
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    ~SlabPool()
+    {
+        m_alloc.deallocate(p_slots, m_capacity);
+    }
+
+    /// @brief Constructs a `T` in a free slot.
+    /// @return Its handle, or `npos` if the pool is exhausted
+    template <class... Args> [[nodiscard]] Handle emplace(Args &&...args)
+    {
+        if (m_free.empty()) [[unlikely]]
+            return npos;
+        const Handle h = m_free.back();
+        m_free.pop_back();
+        std::construct_at(p_slots + h, std::forward<Args>(args)...);
+        return h;
+    }
+
+    void release(Handle h) noexcept
+    {
+        assert(h < m_capacity);
+        m_free.push_back(h);
+    }
+
+    T &operator[](Handle h) noexcept
+    {
+        assert(h < m_capacity);
+        return p_slots[h];
+    }
+
+    const T &operator[](Handle h) const noexcept
+    {
+        assert(h < m_capacity);
+        return p_slots[h];
+    }
+
+    std::uint32_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    std::uint32_t size() const noexcept
+    {
+        return m_capacity - static_cast<std::uint32_t>(m_free.size());
+    }
+
+    bool full() const noexcept
+    {
+        return m_free.empty();
+    }
+};
+
+} // End namespace quick::structs
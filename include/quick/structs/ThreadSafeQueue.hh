@@ -1,47 +1,141 @@
+#pragma once
+
 // C++ Includes
-#include <condition_variable>
-#include <functional>
-#include <mutex>
-#include <queue>
-#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+// QuickLib Includes
+#include "quick/structs/MPMCQueue.hh"
+#include "quick/thread/WaitStrategy.hpp"
 
 namespace quick::structs
 {
 
-/// @brief Generic thread-safe locking queue, backed by std::queue
-/// This is really just a std::dequeue under the hood. We should make
-/// our own container underlying type (like in SPSCQueue.hh)
-/// @attention Prefer the lock-free SPSCQueue instead
-/// @tparam T No array types pls
-template <typename T> class ThreadSafeQueue
+/// @brief Generic thread-safe blocking queue for any number of producers and
+/// consumers, with no mutex and no allocation after construction.
+/// Elements live in a preallocated `MPMCQueue` ring; blocking calls spin
+/// briefly and then sleep on a futex (`SpinBlockWait`), so idle threads cost
+/// nothing and uncontended ops never enter the kernel.
+///
+/// `close()` shuts the queue down: pushes fail from then on, consumers drain
+/// what is left and then get "no element" instead of blocking forever.
+/// @attention Prefer the lock-free SPSCQueue when there is only one producer
+/// and one consumer
+/// @tparam T No array types pls; need not be default constructible (only
+///         the `T&` overloads of `try_pop`/`pop_for` need a `T` to write to)
+/// @tparam CapacityPow2 Ring size; `push` blocks while it is full
+template <typename T, std::uint64_t CapacityPow2 = 1024> class ThreadSafeQueue
 {
   private:
-    std::queue<T> _queue;
-    std::mutex _mutex;
-    std::condition_variable _cv;
+    MPMCQueue<T, CapacityPow2> m_ring;
+    quick::thread::SpinBlockWait m_not_empty;
+    quick::thread::SpinBlockWait m_not_full;
+    std::atomic<bool> m_closed{false};
 
   public:
-    void push(T value)
+    /// @brief Blocks while the queue is full.
+    /// @return false (and drops `value`) if the queue is closed
+    bool push(T value)
+    {
+        // Closed wins over room in the ring, as in try_push
+        if (closed())
+            return false;
+        bool pushed = false;
+        m_not_full.wait([&] { return closed() || (pushed = m_ring.push(std::move(value))); });
+        if (pushed)
+            m_not_empty.notify();
+        return pushed;
+    }
+
+    /// @return false if the queue is full or closed
+    bool try_push(T value)
+    {
+        if (closed() || !m_ring.push(std::move(value)))
+            return false;
+        m_not_empty.notify();
+        return true;
+    }
+
+    /// @return false if the queue is empty
+    bool try_pop(T &out)
+    {
+        if (!m_ring.pop(out))
+            return false;
+        m_not_full.notify();
+        return true;
+    }
+
+    /// @brief Waits up to `timeout` for an element.
+    /// @return false on timeout, or once the queue is closed and drained
+    template <class Rep, class Period> bool pop_for(T &out, std::chrono::duration<Rep, Period> timeout)
+    {
+        bool popped = false;
+        m_not_empty.wait_for([&] { return (popped = m_ring.pop(out)) || closed(); }, timeout);
+        if (popped)
+            m_not_full.notify();
+        return popped;
+    }
+
+    /// @brief Waits for an element.
+    /// @return std::nullopt once the queue is closed and drained
+    std::optional<T> wait_and_pop()
+    {
+        std::optional<T> value;
+        m_not_empty.wait([&] { return (value = m_ring.pop()).has_value() || closed(); });
+        if (value)
+            m_not_full.notify();
+        return value;
+    }
+
+    /// @brief Moves every element currently queued to the back of `out`
+    /// (anything with `push_back`) without blocking.
+    /// @return Number of elements moved
+    template <class Container> std::size_t drain_into(Container &out)
     {
+        std::size_t drained = 0;
+        while (std::optional<T> value = m_ring.pop())
         {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _queue.push(std::move(value));
+            out.push_back(std::move(*value));
+            ++drained;
         }
-        _cv.notify_one();
+        if (drained > 0)
+            m_not_full.notify();
+        return drained;
+    }
+
+    /// @brief Rejects further pushes and wakes every blocked thread.
+    /// Consumers still drain what is queued.
+    void close() noexcept
+    {
+        m_closed.store(true, std::memory_order_release);
+        m_not_empty.notify();
+        m_not_full.notify();
+    }
+
+    bool closed() const noexcept
+    {
+        return m_closed.load(std::memory_order_acquire);
+    }
+
+    /// @brief Snapshot; may be stale by the time it returns.
+    bool empty() const noexcept
+    {
+        return m_ring.empty();
     }
 
-    bool empty()
+    /// @brief Snapshot; may be stale by the time it returns.
+    std::uint64_t size() const noexcept
     {
-        return _queue.empty();
+        return m_ring.size();
     }
 
-    T wait_and_pop()
+    static constexpr std::uint64_t capacity() noexcept
     {
-        std::unique_lock<std::mutex> lock(_mutex);
-        _cv.wait(lock, [&] { return !_queue.empty(); });
-        T val = std::move(_queue.front());
-        _queue.pop();
-        return val;
+        return CapacityPow2;
     }
 };
-} // namespace quick::structs
\ No newline at end of file
+} // namespace quick::structs
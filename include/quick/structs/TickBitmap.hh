@@ -0,0 +1,172 @@
+#pragma once
+
+// C++ Includes
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace quick::structs
+{
+
+/// @brief Hierarchical bitmap over a fixed range of ticks.
+/// Every level keeps one bit per 64-bit word of the level below it, so the
+/// top level is always a single word. set/clear/min/max/next/prev all cost
+/// O(log64 N) word operations: 3 levels cover 262144 ticks, 4 levels cover
+/// ~16M ticks.
+/// @note Storage is allocated once in the constructor and never again.
+class TickBitmap
+{
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  private:
+    static constexpr std::size_t kShift = 6;
+    static constexpr std::size_t kWordBits = std::size_t{1} << kShift;
+    static constexpr std::size_t kMask = kWordBits - 1;
+
+    std::size_t m_size{0};
+    // m_levels.front() holds one bit per tick, m_levels.back() is the root word
+    std::vector<std::vector<std::uint64_t>> m_levels;
+
+    static constexpr std::uint64_t bit(std::size_t b) noexcept
+    {
+        return std::uint64_t{1} << b;
+    }
+
+    // Bits [0, b]
+    static constexpr std::uint64_t up_to(std::size_t b) noexcept
+    {
+        return b == kMask ? ~std::uint64_t{0} : bit(b + 1) - 1;
+    }
+
+    // Bits [b, 63]
+    static constexpr std::uint64_t from(std::size_t b) noexcept
+    {
+        return ~std::uint64_t{0} << b;
+    }
+
+    static constexpr std::size_t highest(std::uint64_t word) noexcept
+    {
+        return kMask - static_cast<std::size_t>(std::countl_zero(word));
+    }
+
+    static constexpr std::size_t lowest(std::uint64_t word) noexcept
+    {
+        return static_cast<std::size_t>(std::countr_zero(word));
+    }
+
+  public:
+    explicit TickBitmap(std::size_t size) : m_size{size}
+    {
+        std::size_t words = size;
+        do
+        {
+            words = (words + kMask) >> kShift;
+            m_levels.emplace_back(std::max<std::size_t>(words, 1), 0);
+        } while (words > 1);
+    }
+
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    bool empty() const noexcept
+    {
+        return m_levels.back().front() == 0;
+    }
+
+    bool test(std::size_t i) const noexcept
+    {
+        assert(i < m_size);
+        return (m_levels.front()[i >> kShift] & bit(i & kMask)) != 0;
+    }
+
+    void set(std::size_t i) noexcept
+    {
+        assert(i < m_size);
+        for (auto &level : m_levels)
+        {
+            std::uint64_t &word = level[i >> kShift];
+            const bool was_empty = word == 0;
+            word |= bit(i & kMask);
+            if (!was_empty)
+                return;
+            i >>= kShift;
+        }
+    }
+
+    void clear(std::size_t i) noexcept
+    {
+        assert(i < m_size);
+        for (auto &level : m_levels)
+        {
+            std::uint64_t &word = level[i >> kShift];
+            word &= ~bit(i & kMask);
+            if (word != 0)
+                return;
+            i >>= kShift;
+        }
+    }
+
+    /// @brief Largest set index <= i, or `npos`.
+    std::size_t prev(std::size_t i) const noexcept
+    {
+        if (m_size == 0)
+            return npos;
+        i = std::min(i, m_size - 1);
+        for (std::size_t l = 0; l < m_levels.size(); ++l)
+        {
+            const std::uint64_t word = m_levels[l][i >> kShift] & up_to(i & kMask);
+            if (word != 0)
+            {
+                i = (i & ~kMask) | highest(word);
+                while (l-- > 0)
+                    i = (i << kShift) | highest(m_levels[l][i]);
+                return i;
+            }
+            if ((i >> kShift) == 0)
+                return npos;
+            i = (i >> kShift) - 1;
+        }
+        return npos;
+    }
+
+    /// @brief Smallest set index >= i, or `npos`.
+    std::size_t next(std::size_t i) const noexcept
+    {
+        if (i >= m_size)
+            return npos;
+        for (std::size_t l = 0; l < m_levels.size(); ++l)
+        {
+            const std::uint64_t word = m_levels[l][i >> kShift] & from(i & kMask);
+            if (word != 0)
+            {
+                i = (i & ~kMask) | lowest(word);
+                while (l-- > 0)
+                    i = (i << kShift) | lowest(m_levels[l][i]);
+                return i;
+            }
+            i = (i >> kShift) + 1;
+            if (i >= m_levels[l].size())
+                return npos;
+        }
+        return npos;
+    }
+
+    std::size_t max() const noexcept
+    {
+        return prev(m_size);
+    }
+
+    std::size_t min() const noexcept
+    {
+        return next(0);
+    }
+};
+
+} // End namespace quick::structs
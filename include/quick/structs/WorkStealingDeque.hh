@@ -0,0 +1,116 @@
+#pragma once
+
+// C++ Includes
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+// QuickLib Includes
+#include "quick/structs/SPSCQueue.hh"
+
+namespace quick::structs
+{
+
+/// @brief Bounded Chase-Lev work-stealing deque (the C11 formulation by Lê,
+/// Pop, Cohen and Zappa Nardelli).
+/// The owner thread pushes and pops at the bottom (LIFO, cache-hot);
+/// any number of thieves steal from the top (FIFO, oldest work first).
+/// Owner ops touch only the bottom index unless the deque is down to its
+/// last element, where owner and thieves settle it with one CAS.
+/// @tparam T Trivially copyable (typically a pointer): a thief may read a
+///         slot it then fails to claim
+/// @tparam CapacityPow2 Power-of-two number of slots
+template <class T, std::uint64_t CapacityPow2> class WorkStealingDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements are read racily by thieves");
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be a power of two");
+    static constexpr std::int64_t kCapacity = static_cast<std::int64_t>(CapacityPow2);
+    static constexpr std::int64_t kMask = kCapacity - 1;
+
+    alignas(cacheline_t::value) std::atomic<std::int64_t> m_top{0};    // thieves' end
+    alignas(cacheline_t::value) std::atomic<std::int64_t> m_bottom{0}; // owner's end
+    alignas(cacheline_t::value) std::atomic<T> m_slots[CapacityPow2]{};
+
+  public:
+    WorkStealingDeque() = default;
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    /// @brief Owner only.
+    /// @return false if the deque is full
+    bool push(T item) noexcept
+    {
+        const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= kCapacity) [[unlikely]]
+            return false;
+        m_slots[bottom & kMask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief Owner only: newest element.
+    std::optional<T> pop() noexcept
+    {
+        const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            // Empty: undo the reservation
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item{m_slots[bottom & kMask].load(std::memory_order_relaxed)};
+        if (top == bottom)
+        {
+            // Last element: race the thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item.reset();
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// @brief Any thread: oldest element.
+    /// @return std::nullopt if empty or another thread won the race (retry
+    ///         elsewhere)
+    std::optional<T> steal() noexcept
+    {
+        std::int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return std::nullopt;
+
+        const T item = m_slots[top & kMask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return std::nullopt;
+        return item;
+    }
+
+    /// @brief Approximate from any thread other than the owner.
+    std::int64_t size() const noexcept
+    {
+        const std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? bottom - top : 0;
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    static constexpr std::uint64_t capacity() noexcept
+    {
+        return CapacityPow2;
+    }
+};
+
+} // End namespace quick::structs
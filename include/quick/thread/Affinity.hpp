@@ -0,0 +1,115 @@
+#pragma once
+
+// C Includes
+#include <pthread.h>
+#include <sched.h>
+
+// C++ Includes
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace quick::thread
+{
+
+/// @brief Restricts `handle` to the given CPUs.
+/// @return false if a CPU id is out of range or the kernel refused (offline
+///         core, cgroup/cpuset restrictions, ...)
+inline bool pin_thread(pthread_t handle, std::span<const int> cpus) noexcept
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus)
+    {
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpu, &set);
+    }
+    return ::pthread_setaffinity_np(handle, sizeof(set), &set) == 0;
+}
+
+inline bool pin_thread(pthread_t handle, int cpu) noexcept
+{
+    return pin_thread(handle, std::span<const int>{&cpu, 1});
+}
+
+/// @brief Names a thread so it shows up in top/perf/gdb.
+/// @note Linux caps names at 15 characters; longer names are truncated.
+inline bool name_thread(pthread_t handle, std::string_view name) noexcept
+{
+    char buf[16]{};
+    name.copy(buf, sizeof(buf) - 1);
+    return ::pthread_setname_np(handle, buf) == 0;
+}
+
+/// @brief Parses a kernel CPU list such as "0-3,8,10-11" (the sysfs
+/// `cpulist` format).
+/// @return The CPU ids in order; malformed entries are skipped
+inline std::vector<int> parse_cpu_list(std::string_view list)
+{
+    std::vector<int> cpus;
+    while (!list.empty())
+    {
+        const std::size_t comma = list.find(',');
+        const std::string_view item = list.substr(0, comma);
+        list = comma == std::string_view::npos ? std::string_view{} : list.substr(comma + 1);
+
+        int first = 0;
+        auto [end, ec] = std::from_chars(item.data(), item.data() + item.size(), first);
+        if (ec != std::errc{})
+            continue;
+        int last = first;
+        if (end != item.data() + item.size() && *end == '-')
+            std::from_chars(end + 1, item.data() + item.size(), last);
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+struct NumaNode
+{
+    int id;
+    std::vector<int> cpus;
+};
+
+/// @brief NUMA nodes and their CPUs, read from sysfs (no libnuma needed).
+/// Machines without NUMA, or without sysfs, report a single node holding
+/// every CPU.
+inline std::vector<NumaNode> numa_nodes()
+{
+    std::vector<NumaNode> nodes;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator{"/sys/devices/system/node", ec})
+    {
+        const std::string name = entry.path().filename().string();
+        if (!name.starts_with("node") || name.size() == 4)
+            continue;
+        int id = 0;
+        if (std::from_chars(name.data() + 4, name.data() + name.size(), id).ec != std::errc{})
+            continue;
+        std::ifstream file{entry.path() / "cpulist"};
+        std::string list;
+        std::getline(file, list);
+        if (auto cpus = parse_cpu_list(list); !cpus.empty()) // memory-only nodes have no CPUs
+            nodes.push_back({id, std::move(cpus)});
+    }
+    std::ranges::sort(nodes, {}, &NumaNode::id);
+
+    if (nodes.empty())
+    {
+        NumaNode all{0, {}};
+        for (unsigned cpu = 0; cpu < std::max(1U, std::thread::hardware_concurrency()); ++cpu)
+            all.cpus.push_back(static_cast<int>(cpu));
+        nodes.push_back(std::move(all));
+    }
+    return nodes;
+}
+
+} // End namespace quick::thread
@@ -1,30 +1,161 @@
+#pragma once
+
+// C Includes
+#include <sched.h>
+
 // C++ Includes
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <format>
 #include <functional>
 #include <future>
+#include <iterator>
+#include <latch>
+#include <memory>
+#include <new>
 #include <print>
-#include <queue>
 #include <ranges>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+// QuickLib Includes
+#include "quick/structs/MPMCQueue.hh"
+#include "quick/structs/WorkStealingDeque.hh"
+#include "quick/thread/Affinity.hpp"
+#include "quick/thread/WaitStrategy.hpp"
 #include "quick/utils/Timer.hh"
+#include "quick/utils/XorBitant.hh"
 
 namespace quick::thread
 {
 
-namespace
+/// @brief Lightweight completion handle for `ThreadPool::post`: counts tasks
+/// posted against it and lets a thread wait until all of them finished.
+/// One atomic, no shared state allocation, no result or exception transport
+/// (use `enqueue` and its future for those). Reusable once `wait()` returns.
+class Completion
 {
-thread_local int t_thread_id = -1;
-}
+    std::atomic<std::uint32_t> m_outstanding{0};
+
+  public:
+    Completion() = default;
+    Completion(const Completion &) = delete;
+    Completion &operator=(const Completion &) = delete;
+
+    void add(std::uint32_t count = 1) noexcept
+    {
+        m_outstanding.fetch_add(count, std::memory_order_relaxed);
+    }
 
+    void done() noexcept
+    {
+        // Like std::latch: the waiter may destroy us as soon as it sees zero,
+        // and notify only needs the address, not the object
+        if (m_outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            m_outstanding.notify_all();
+    }
+
+    bool ready() const noexcept
+    {
+        return m_outstanding.load(std::memory_order_acquire) == 0;
+    }
+
+    /// @brief Spins briefly, then sleeps until every task posted against this
+    /// handle has run.
+    void wait() const noexcept
+    {
+        for (std::uint32_t i = 0; i < 1024; ++i)
+        {
+            if (ready())
+                return;
+            _mm_pause();
+        }
+        for (std::uint32_t left; (left = m_outstanding.load(std::memory_order_acquire)) != 0;)
+            m_outstanding.wait(left, std::memory_order_acquire);
+    }
+};
+
+/// @brief Dispatch class of a ThreadPool task, most urgent first.
+enum class Priority : std::uint8_t
+{
+    URGENT,
+    NORMAL,
+    BACKGROUND
+};
+inline constexpr std::size_t kPriorityLevels = 3;
+
+/// @brief Where ThreadPool workers run and what they are called.
+struct ThreadPoolOptions
+{
+    std::size_t num_threads{std::thread::hardware_concurrency()};
+
+    /// @brief CPUs the workers may run on; empty leaves placement to the OS.
+    std::vector<int> cpus{};
+
+    /// @brief With `cpus`: pin worker i to `cpus[i % cpus.size()]` alone
+    /// (isolated cores) instead of letting every worker float over the set.
+    bool pin_per_cpu{true};
+
+    /// @brief Group workers by NUMA node: each node gets its own injection
+    /// queue, outside submissions go to the submitter's node, and workers
+    /// look for work on their own node before crossing over. Without `cpus`,
+    /// workers are spread round-robin over the nodes and pinned to them.
+    bool numa_aware{false};
+
+    /// @brief Workers are named "<name>-<index>", cut to Linux's 15
+    /// characters; empty leaves them unnamed.
+    std::string name{"quick-pool"};
+};
+
+/// @brief Work-stealing thread pool.
+/// Every worker owns a Chase-Lev deque, and each worker group (NUMA node)
+/// has one lock-free MPMC injection queue per `Priority`. NORMAL tasks
+/// enqueued from inside a worker go to the bottom of its own deque and are
+/// popped LIFO while still cache-hot; once that deque is full they go to the
+/// worker's node queue for NORMAL. URGENT and BACKGROUND tasks from workers,
+/// and every task from outside, go to the node queue for their level (the
+/// submitter's node). A full injection queue throttles the submitter: an
+/// outside thread yields until workers make room, a worker runs queued tasks
+/// meanwhile. Task counts are kept per worker and summed on read.
+///
+/// A worker that runs dry looks at each level in turn: its node's injection
+/// queue, then (NORMAL only) the oldest task of the node's other workers,
+/// starting at a random victim, then the same on remote nodes. Only then
+/// does it park on its own futex (`SpinBlockWait`). Each submission wakes at
+/// most one parked worker, and costs a fence and a load while none are
+/// parked.
+///
+/// Tasks live in a slab of cacheline-sized slots preallocated by the
+/// constructor: a callable of up to `kInlineTaskBytes` is constructed in
+/// place, so `post()` allocates nothing. Workers keep a few free slots to
+/// themselves and trade them with the shared free list in batches. Bigger
+/// callables are boxed on the heap, and a drained slab falls back to heap
+/// slots rather than blocking.
+///
+/// Workers take URGENT work first, but every `kNormalEvery`-th dispatch
+/// starts at NORMAL and every `kBackgroundEvery`-th at BACKGROUND, so a
+/// flood of urgent work slows lower levels down without starving them.
+///
+/// Workers can be pinned, named and grouped per NUMA node
+/// (`ThreadPoolOptions`). Each worker allocates its own deque after pinning,
+/// and the first worker of each group its injection queues, so the memory
+/// they touch most is local to them.
+///
+/// Destruction runs every task already enqueued (including ones those tasks
+/// enqueue) before joining the workers.
 class ThreadPool
 {
   public:
-    ThreadPool() = default;
-    ThreadPool(std::size_t num_threads);
+    explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency());
+    explicit ThreadPool(ThreadPoolOptions options);
 
     ThreadPool(const ThreadPool &) = delete;
     ThreadPool &operator=(const ThreadPool &) = delete;
@@ -34,91 +165,849 @@ class ThreadPool
 
     template <class F, class... Args>
     auto enqueue(F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /// @brief Fire-and-forget: runs `fn()` on a worker. No allocation when
+    /// `fn` fits a task slot.
+    /// @attention `fn` must not throw (std::terminate); use `enqueue` to get
+    /// exceptions back
+    template <class F> void post(F &&fn);
+
+    /// @brief `post`, then marks `completion` done once `fn()` has run.
+    template <class F> void post(Completion &completion, F &&fn);
+
+    /// @brief `enqueue` / `post` at a given priority (the overloads above
+    /// use NORMAL).
+    template <class F, class... Args>
+    auto enqueue(Priority priority, F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>;
+    template <class F> void post(Priority priority, F &&fn);
+    template <class F> void post(Priority priority, Completion &completion, F &&fn);
+
+    /// @brief Blocks until `completion` is ready, running pool tasks on the
+    /// calling thread meanwhile (its own deque first if it is one of our
+    /// workers, so nested waits never deadlock).
+    void wait(Completion &completion);
+
+    /// @brief Calls `fn(i)` for every i in [first, last).
+    /// The range is split in halves down to `grain` indices per task; the
+    /// calling thread keeps the leftmost half at every split and then helps
+    /// with the rest. `grain == 0` picks one from the pool size. The first
+    /// exception thrown by `fn` is rethrown here (remaining chunks are
+    /// skipped).
+    template <class Fn> void parallel_for(std::size_t first, std::size_t last, std::size_t grain, Fn &&fn);
+
+    /// @brief Calls `fn(element)` for every element of a random-access range.
+    template <std::ranges::random_access_range R, class Fn>
+        requires std::ranges::sized_range<R>
+    void parallel_for(R &&range, std::size_t grain, Fn &&fn);
+
+    /// @brief Folds `reduce(acc, map(element))` over a random-access range.
+    /// Chunks of `grain` elements are folded in parallel from `identity`, then
+    /// the per-chunk results are folded in order on the caller, so the result
+    /// is deterministic for a given grain even when `reduce` isn't
+    /// associative (floating point).
+    template <std::ranges::random_access_range R, class T, class Reduce, class Map = std::identity>
+        requires std::ranges::sized_range<R>
+    T parallel_reduce(R &&range, std::size_t grain, T identity, Reduce reduce, Map map = {});
+
+    /// @brief `output[i] = fn(input[i])` for every element of `input`.
+    /// `output` must be at least as long as `input`.
+    template <std::ranges::random_access_range In, std::ranges::random_access_range Out, class Fn>
+        requires std::ranges::sized_range<In>
+    void parallel_transform(In &&input, Out &&output, std::size_t grain, Fn &&fn);
+
     std::string get_thread_id() const noexcept;
     std::size_t get_num_active_tasks() const noexcept;
+    /// @brief Tasks of one priority enqueued but not yet started (a snapshot).
+    std::size_t get_queue_depth(Priority priority) const noexcept;
     std::size_t get_num_threads() const noexcept;
+    /// @brief Worker groups with their own injection queue: NUMA nodes in
+    /// use with `numa_aware`, 1 otherwise.
+    std::size_t get_num_nodes() const noexcept;
+    /// @brief Whether `worker` runs restricted to its CPUs from
+    /// `ThreadPoolOptions::cpus` (or its node's with `numa_aware`). False when
+    /// it was left to the OS or the kernel refused (offline core, cpuset).
+    bool is_pinned(std::size_t worker) const noexcept;
+
+    /// @brief Largest callable (captures included) stored without allocating,
+    /// with or without a Completion.
+    static constexpr std::size_t kInlineTaskBytes = 48;
+    /// @brief Starvation avoidance: dispatch periods at which a worker looks
+    /// at NORMAL / BACKGROUND work before URGENT work.
+    static constexpr std::uint32_t kNormalEvery = 8;
+    static constexpr std::uint32_t kBackgroundEvery = 32;
 
   private:
+    // One slab slot: the callable lives in `storage`, `run` invokes and
+    // destroys it, then `completion` (if any) is marked done
+    struct alignas(quick::structs::cacheline_t::value) Task
+    {
+        void (*run)(Task &) noexcept;
+        Completion *completion;
+        alignas(std::max_align_t) std::byte storage[kInlineTaskBytes];
+    };
+    static_assert(sizeof(Task) == quick::structs::cacheline_t::value);
+
+    // A task taken off a queue, with the level it was queued at
+    struct Taken
+    {
+        Task *task{nullptr};
+        Priority priority{Priority::NORMAL};
+
+        explicit operator bool() const noexcept
+        {
+            return task != nullptr;
+        }
+    };
+
+    static constexpr std::uint64_t kLocalQueueDepth = 1 << 12;
+    static constexpr std::uint64_t kInjectQueueDepth = 1 << 12;
+    static constexpr std::uint32_t kSlabSlots = 1 << 12;
+    static constexpr std::uint32_t kHeapSlot = ~std::uint32_t{0};
+    // Free slots a worker keeps to itself, moved to/from the shared list
+    // half a cache at a time
+    static constexpr std::uint32_t kCachedSlots = 64;
+    // Each idle spin scans every victim, so park sooner than a queue would
+    static constexpr std::uint32_t kIdleSpins = 256;
+
+    // Task counts of one thread (or of all outside threads): tasks submitted
+    // and started per level, and tasks finished
+    struct Counts
+    {
+        std::array<std::atomic<std::uint64_t>, kPriorityLevels> submitted{};
+        std::array<std::atomic<std::uint64_t>, kPriorityLevels> started{};
+        std::atomic<std::uint64_t> completed{0};
+    };
+
+    struct Worker
+    {
+        quick::structs::WorkStealingDeque<Task *, kLocalQueueDepth> deque;
+        XorBitant rng;
+        SpinBlockWait park{kIdleSpins};
+        std::size_t node;
+        std::uint32_t dispatches{0}; // drives the priority rotation
+        std::uint32_t num_free{0};
+        std::array<std::uint32_t, kCachedSlots> free_slots;
+        bool pinned;
+        // Parked or about to; cleared by whoever wakes it. Its own line, so
+        // a waker's CAS doesn't hit the fields above on every task
+        alignas(quick::structs::cacheline_t::value) std::atomic<bool> idle{false};
+        // Written by this worker only and summed on read, so local spawns
+        // touch no shared cache line
+        alignas(quick::structs::cacheline_t::value) Counts counts;
+
+        Worker(std::uint64_t seed, std::size_t node_index, bool is_pinned)
+            : rng{seed}, node{node_index}, pinned{is_pinned}
+        {
+        }
+    };
+
+    // Worker group: one per NUMA node in use (just one without numa_aware)
+    struct Node
+    {
+        std::array<quick::structs::MPMCQueue<Task *, kInjectQueueDepth>, kPriorityLevels> injected;
+        std::vector<std::size_t> workers;
+
+        explicit Node(std::vector<std::size_t> members) : workers{std::move(members)}
+        {
+        }
+    };
+
+    // Where one worker runs: the CPUs to pin it to (empty: anywhere) and its
+    // group. The group's first worker also gets its members and builds it
+    struct Placement
+    {
+        std::vector<int> cpus;
+        std::size_t node;
+        std::vector<std::size_t> members;
+    };
+
+    // Shared by every task of one parallel_* call, on the caller's stack
+    struct ForkJoin
+    {
+        Completion done;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+    };
+
+    std::vector<Placement> place_workers(const ThreadPoolOptions &options);
+    std::size_t current_node() const noexcept;
+
+    std::size_t auto_grain(std::size_t count) const noexcept;
+    template <class Body> void fork_join(std::size_t first, std::size_t last, std::size_t grain, Body &&body);
+    template <class Body>
+    void split(std::size_t first, std::size_t last, std::size_t grain, Body &body, ForkJoin &join);
+
+    template <class F> Task *make_task(F &&fn);
+    Task *acquire_slot();
+    std::uint32_t slot_of(const Task *task) const noexcept;
+    void release_slot(Task *task) noexcept;
+    void submit(Task *task, Priority priority);
+    void inject(Task *task, Priority priority, std::size_t node);
+    Taken find_task(std::size_t self);
+    Task *take_shared(std::size_t node, Priority priority, std::size_t start, std::size_t skip);
+    Taken take_any(std::size_t node, std::size_t start, std::size_t skip);
+    void run(Taken taken);
+    Counts &counts() noexcept;
+    void count(std::atomic<std::uint64_t> &counter) noexcept;
+    template <class Pick> std::uint64_t sum(Pick pick) const noexcept;
+    std::uint64_t pending() const noexcept;
+    void wake_one(std::size_t node) noexcept;
+    void wake_all() noexcept;
+    void worker_loop(std::size_t self);
+
     std::size_t m_num_threads{0};
-    std::queue<std::move_only_function<void()>> m_tasks;
-    std::vector<std::jthread> m_workers;
-    mutable std::mutex m_mutex;
-    std::counting_semaphore<> m_semaphore{0};
-    std::atomic<std::size_t> m_active_tasks{0};
+    std::latch m_started;
+    std::vector<std::unique_ptr<Worker>> m_workers; // filled in by the workers themselves
+    std::vector<std::unique_ptr<Node>> m_nodes;
+    std::vector<std::size_t> m_cpu_node; // CPU id -> index into m_nodes
+    std::vector<std::jthread> m_threads;
+    std::unique_ptr<Task[]> p_slab{std::make_unique<Task[]>(kSlabSlots)};
+    quick::structs::MPMCQueue<std::uint32_t, kSlabSlots> m_free_slots;
+    // Submissions and runs by threads that aren't our workers
+    alignas(quick::structs::cacheline_t::value) Counts m_outside;
+    alignas(quick::structs::cacheline_t::value) std::atomic<std::size_t> m_idle_workers{0};
+    std::atomic<std::size_t> m_wake_cursor{0};
     std::atomic_bool m_stopping{false};
+
+    // Which pool (if any) the calling thread works for, and its index there
+    static inline thread_local const ThreadPool *t_pool = nullptr;
+    static inline thread_local std::size_t t_worker = 0;
 };
 
-ThreadPool::ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency()) : m_num_threads{num_threads}
+inline ThreadPool::ThreadPool(std::size_t num_threads) : ThreadPool{ThreadPoolOptions{.num_threads = num_threads}}
+{
+}
+
+inline ThreadPool::ThreadPool(ThreadPoolOptions options)
+    : m_num_threads{std::max<std::size_t>(options.num_threads, 1)},
+      m_started{static_cast<std::ptrdiff_t>(m_num_threads)}, m_workers(m_num_threads)
 {
     quick::utils::Timer timer{"ThreadPool ctor"};
-    using namespace std::chrono_literals;
-    // auto stop_token = m_stop_source.get_token();
-    m_workers.reserve(num_threads);
-    auto range = std::views::iota(0, static_cast<int>(num_threads));
-    std::ranges::for_each(range, [this](int thread_id) {
-        m_workers.emplace_back([this, thread_id](std::stop_token stoken) {
-            while (!stoken.stop_requested() and !m_stopping.load(std::memory_order_acquire))
-            {
-                /// @todo Investigate how this blocks (spin? futex?)
-                m_semaphore.acquire();
-
-                /// @todo do we need the empty task check? we are doing it
-                /// in the scoped block anyway.
-                if (stoken.stop_requested() && m_tasks.empty())
-                    break;
-
-                std::move_only_function<void()> task;
-                {
-                    std::scoped_lock<std::mutex> lock(m_mutex);
-                    if (m_tasks.empty())
-                        continue;
-                    task = std::move(m_tasks.front());
-                    m_tasks.pop();
-                }
-
-                t_thread_id = thread_id;
-                task();
-            }
+    for (std::uint32_t slot = 0; slot < kSlabSlots; ++slot)
+        m_free_slots.push(slot);
+
+    std::vector<Placement> placements = place_workers(options);
+    m_threads.reserve(m_num_threads);
+    for (std::size_t id = 0; id < m_num_threads; ++id)
+    {
+        m_threads.emplace_back([this, id, name = options.name, placement = std::move(placements[id])]() mutable {
+            // Cpusets may refuse: the worker still runs, is_pinned() tells
+            const bool pinned = !placement.cpus.empty() && pin_thread(::pthread_self(), placement.cpus);
+            if (!name.empty())
+                name_thread(::pthread_self(), std::format("{}-{}", name, id));
+            // Allocated after pinning, so first touch puts it on our node
+            m_workers[id] = std::make_unique<Worker>(0x9E37'79B9'7F4A'7C15ULL * (id + 1), placement.node, pinned);
+            if (!placement.members.empty())
+                m_nodes[placement.node] = std::make_unique<Node>(std::move(placement.members));
+            // Steal from nobody until every worker exists
+            m_started.arrive_and_wait();
+            worker_loop(id);
         });
-    });
+    }
+    m_started.wait();
 }
 
-std::size_t ThreadPool::get_num_threads() const noexcept
+inline std::vector<ThreadPool::Placement> ThreadPool::place_workers(const ThreadPoolOptions &options)
+{
+    // CPU groups workers are spread over, one per Node
+    std::vector<std::vector<int>> groups;
+    std::vector<NumaNode> topology;
+    if (options.numa_aware)
+    {
+        topology = numa_nodes();
+        for (const NumaNode &numa : topology)
+        {
+            std::vector<int> cpus;
+            for (int cpu : numa.cpus)
+                if (options.cpus.empty() || std::ranges::find(options.cpus, cpu) != options.cpus.end())
+                    cpus.push_back(cpu);
+            if (!cpus.empty())
+                groups.push_back(std::move(cpus));
+        }
+    }
+    if (groups.empty())
+        groups.push_back(options.cpus);
+    // No empty groups: fewer workers than nodes uses the first nodes only
+    groups.resize(std::min(groups.size(), m_num_threads));
+
+    // Built by their first worker, once pinned (the injection queues are
+    // written through on construction)
+    m_nodes.resize(groups.size());
+    for (std::size_t group = 0; group < groups.size(); ++group)
+    {
+        for (int cpu : groups[group])
+        {
+            if (static_cast<std::size_t>(cpu) >= m_cpu_node.size())
+                m_cpu_node.resize(static_cast<std::size_t>(cpu) + 1, 0);
+            m_cpu_node[static_cast<std::size_t>(cpu)] = group;
+        }
+    }
+
+    std::vector<Placement> placements;
+    placements.reserve(m_num_threads);
+    for (std::size_t id = 0; id < m_num_threads; ++id)
+    {
+        const std::size_t group = id % groups.size();
+        const std::vector<int> &cpus = groups[group];
+        if (options.pin_per_cpu && !options.cpus.empty())
+            placements.push_back({{cpus[(id / groups.size()) % cpus.size()]}, group, {}});
+        else
+            placements.push_back({cpus, group, {}});
+        placements[group].members.push_back(id);
+    }
+    return placements;
+}
+
+/// Group of the CPU the caller is running on (0 when there is one group).
+inline std::size_t ThreadPool::current_node() const noexcept
+{
+    if (m_nodes.size() == 1)
+        return 0;
+    const int cpu = ::sched_getcpu();
+    return cpu >= 0 && static_cast<std::size_t>(cpu) < m_cpu_node.size() ? m_cpu_node[static_cast<std::size_t>(cpu)]
+                                                                          : 0;
+}
+
+inline std::size_t ThreadPool::get_num_threads() const noexcept
 {
     return m_num_threads;
 }
 
-std::size_t ThreadPool::get_num_active_tasks() const noexcept
+inline std::size_t ThreadPool::get_num_nodes() const noexcept
+{
+    return m_nodes.size();
+}
+
+inline bool ThreadPool::is_pinned(std::size_t worker) const noexcept
 {
-    std::scoped_lock<std::mutex> lock(m_mutex);
-    return m_tasks.size();
+    return worker < m_num_threads && m_workers[worker]->pinned;
 }
 
-std::string ThreadPool::get_thread_id() const noexcept
+/// Tasks enqueued or running (a snapshot).
+inline std::size_t ThreadPool::get_num_active_tasks() const noexcept
 {
-    return std::format("{}", t_thread_id);
+    return static_cast<std::size_t>(pending());
+}
+
+inline std::size_t ThreadPool::get_queue_depth(Priority priority) const noexcept
+{
+    const auto level = static_cast<std::size_t>(priority);
+    // Starts first, like pending()
+    const std::uint64_t started = sum([level](const Counts &counts) -> auto & { return counts.started[level]; });
+    return static_cast<std::size_t>(
+        sum([level](const Counts &counts) -> auto & { return counts.submitted[level]; }) - started);
+}
+
+/// The calling worker's index in this pool, or -1 from any other thread.
+inline std::string ThreadPool::get_thread_id() const noexcept
+{
+    return t_pool == this ? std::format("{}", t_worker) : std::string{"-1"};
 }
 
 template <class F, class... Args>
 auto ThreadPool::enqueue(F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>
+{
+    return enqueue(Priority::NORMAL, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template <class F, class... Args>
+auto ThreadPool::enqueue(Priority priority, F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>
 {
     using Ret = std::invoke_result_t<F, Args...>;
     auto task = std::packaged_task<Ret()>(std::bind_front(std::forward<F>(f), std::forward<Args>(args)...));
     auto fut = task.get_future();
+    // packaged_task is two pointers: fits a slot, so the only allocation is
+    // the future's shared state
+    submit(make_task([task = std::move(task)]() mutable { task(); }), priority);
+    return fut;
+}
+
+template <class F> void ThreadPool::post(F &&fn)
+{
+    post(Priority::NORMAL, std::forward<F>(fn));
+}
+
+template <class F> void ThreadPool::post(Completion &completion, F &&fn)
+{
+    post(Priority::NORMAL, completion, std::forward<F>(fn));
+}
+
+template <class F> void ThreadPool::post(Priority priority, F &&fn)
+{
+    submit(make_task(std::forward<F>(fn)), priority);
+}
+
+template <class F> void ThreadPool::post(Priority priority, Completion &completion, F &&fn)
+{
+    Task *task = make_task(std::forward<F>(fn));
+    // Kept next to the callable rather than captured, so `fn` gets the whole
+    // kInlineTaskBytes
+    task->completion = &completion;
+    completion.add();
+    submit(task, priority);
+}
+
+inline void ThreadPool::wait(Completion &completion)
+{
+    std::size_t victim = t_worker;
+    for (std::uint32_t idle = 0; !completion.ready();)
     {
-        std::scoped_lock lock(m_mutex);
-        m_tasks.emplace(std::move(task));
+        Taken taken = t_pool == this ? find_task(t_worker) : take_any(current_node(), victim++, m_num_threads);
+        if (taken)
+        {
+            run(taken);
+            idle = 0;
+        }
+        else if (++idle < kIdleSpins)
+            _mm_pause();
+        else
+        {
+            // Nothing left to help with: the rest is already running
+            completion.wait();
+            return;
+        }
     }
-    m_semaphore.release();
-    return fut;
 }
 
-ThreadPool::~ThreadPool()
+inline std::size_t ThreadPool::auto_grain(std::size_t count) const noexcept
 {
-    m_stopping.store(true, std::memory_order_release);
-    std::ranges::for_each(m_workers, [this](auto &thread) {
-        m_semaphore.release();
-        thread.request_stop();
+    // ~8 chunks per thread (workers + caller): enough slack for stealing
+    // to even out uneven chunks, few enough to amortize a task each
+    return std::max<std::size_t>(1, count / (8 * (m_num_threads + 1)));
+}
+
+template <class Body>
+void ThreadPool::fork_join(std::size_t first, std::size_t last, std::size_t grain, Body &&body)
+{
+    if (first >= last)
+        return;
+    ForkJoin join;
+    join.done.add();
+    split(first, last, grain ? grain : auto_grain(last - first), body, join);
+    wait(join.done);
+    if (join.error)
+        std::rethrow_exception(join.error);
+}
+
+template <class Body>
+void ThreadPool::split(std::size_t first, std::size_t last, std::size_t grain, Body &body, ForkJoin &join)
+{
+    // Hand off the right half until what is left is one grain; thieves take
+    // the biggest (oldest) halves first, and split those further themselves
+    while (last - first > grain)
+    {
+        const std::size_t mid = first + (last - first) / 2;
+        join.done.add();
+        post([this, mid, last, grain, &body, &join] { split(mid, last, grain, body, join); });
+        last = mid;
+    }
+    if (!join.failed.load(std::memory_order_relaxed))
+    {
+        try
+        {
+            body(first, last);
+        }
+        catch (...)
+        {
+            if (!join.failed.exchange(true, std::memory_order_relaxed))
+                join.error = std::current_exception();
+        }
+    }
+    join.done.done();
+}
+
+template <class Fn> void ThreadPool::parallel_for(std::size_t first, std::size_t last, std::size_t grain, Fn &&fn)
+{
+    fork_join(first, last, grain, [&fn](std::size_t lo, std::size_t hi) {
+        for (std::size_t i = lo; i < hi; ++i)
+            fn(i);
     });
 }
+
+template <std::ranges::random_access_range R, class Fn>
+    requires std::ranges::sized_range<R>
+void ThreadPool::parallel_for(R &&range, std::size_t grain, Fn &&fn)
+{
+    using Diff = std::ranges::range_difference_t<R>;
+    auto begin = std::ranges::begin(range);
+    fork_join(0, static_cast<std::size_t>(std::ranges::size(range)), grain,
+              [&fn, begin](std::size_t lo, std::size_t hi) {
+                  for (std::size_t i = lo; i < hi; ++i)
+                      fn(begin[static_cast<Diff>(i)]);
+              });
+}
+
+template <std::ranges::random_access_range R, class T, class Reduce, class Map>
+    requires std::ranges::sized_range<R>
+T ThreadPool::parallel_reduce(R &&range, std::size_t grain, T identity, Reduce reduce, Map map)
+{
+    using Diff = std::ranges::range_difference_t<R>;
+    const auto count = static_cast<std::size_t>(std::ranges::size(range));
+    if (count == 0)
+        return identity;
+    grain = grain ? grain : auto_grain(count);
+
+    // One result per chunk, each on its own cache line
+    struct alignas(quick::structs::cacheline_t::value) Partial
+    {
+        T value;
+    };
+    const std::size_t chunks = (count + grain - 1) / grain;
+    std::vector<Partial> partials(chunks, Partial{identity});
+
+    auto begin = std::ranges::begin(range);
+    fork_join(0, chunks, 1, [&, begin](std::size_t lo, std::size_t hi) {
+        for (std::size_t chunk = lo; chunk < hi; ++chunk)
+        {
+            T acc = identity;
+            const std::size_t end = std::min(count, (chunk + 1) * grain);
+            for (std::size_t i = chunk * grain; i < end; ++i)
+                acc = reduce(std::move(acc), std::invoke(map, begin[static_cast<Diff>(i)]));
+            partials[chunk].value = std::move(acc);
+        }
+    });
+
+    T result = std::move(identity);
+    for (Partial &partial : partials)
+        result = reduce(std::move(result), std::move(partial.value));
+    return result;
+}
+
+template <std::ranges::random_access_range In, std::ranges::random_access_range Out, class Fn>
+    requires std::ranges::sized_range<In>
+void ThreadPool::parallel_transform(In &&input, Out &&output, std::size_t grain, Fn &&fn)
+{
+    using InDiff = std::ranges::range_difference_t<In>;
+    using OutDiff = std::ranges::range_difference_t<Out>;
+    auto in = std::ranges::begin(input);
+    auto out = std::ranges::begin(output);
+    fork_join(0, static_cast<std::size_t>(std::ranges::size(input)), grain,
+              [&fn, in, out](std::size_t lo, std::size_t hi) {
+                  for (std::size_t i = lo; i < hi; ++i)
+                      out[static_cast<OutDiff>(i)] = fn(in[static_cast<InDiff>(i)]);
+              });
+}
+
+template <class F> ThreadPool::Task *ThreadPool::make_task(F &&fn)
+{
+    using Fn = std::decay_t<F>;
+    Task *task = acquire_slot();
+    task->completion = nullptr;
+    try
+    {
+        if constexpr (sizeof(Fn) <= kInlineTaskBytes && alignof(Fn) <= alignof(std::max_align_t))
+        {
+            ::new (static_cast<void *>(task->storage)) Fn(std::forward<F>(fn));
+            task->run = [](Task &self) noexcept {
+                Fn &callable = *std::launder(reinterpret_cast<Fn *>(self.storage));
+                callable();
+                std::destroy_at(&callable);
+            };
+        }
+        else
+        {
+            // Too big for a slot: box it, one allocation
+            using Box = std::unique_ptr<Fn>;
+            ::new (static_cast<void *>(task->storage)) Box(std::make_unique<Fn>(std::forward<F>(fn)));
+            task->run = [](Task &self) noexcept {
+                Box &box = *std::launder(reinterpret_cast<Box *>(self.storage));
+                (*box)();
+                std::destroy_at(&box);
+            };
+        }
+    }
+    catch (...)
+    {
+        release_slot(task);
+        throw;
+    }
+    return task;
+}
+
+inline ThreadPool::Task *ThreadPool::acquire_slot()
+{
+    std::uint32_t slot = 0;
+    if (t_pool == this)
+    {
+        // Workers take from their own cache, refilled from the shared list
+        Worker &me = *m_workers[t_worker];
+        if (me.num_free == 0)
+            while (me.num_free < kCachedSlots / 2 && m_free_slots.pop(slot))
+                me.free_slots[me.num_free++] = slot;
+        if (me.num_free > 0) [[likely]]
+            return &p_slab[me.free_slots[--me.num_free]];
+    }
+    else if (m_free_slots.pop(slot))
+        return &p_slab[slot];
+    // Slab drained (a burst deeper than kSlabSlots): heap slot, freed on run
+    return new Task;
+}
+
+/// Index of `task` in the slab, or kHeapSlot for a heap slot.
+inline std::uint32_t ThreadPool::slot_of(const Task *task) const noexcept
+{
+    const std::uintptr_t offset =
+        reinterpret_cast<std::uintptr_t>(task) - reinterpret_cast<std::uintptr_t>(p_slab.get());
+    return offset < kSlabSlots * sizeof(Task) ? static_cast<std::uint32_t>(offset / sizeof(Task)) : kHeapSlot;
+}
+
+inline void ThreadPool::release_slot(Task *task) noexcept
+{
+    const std::uint32_t slot = slot_of(task);
+    if (slot == kHeapSlot) [[unlikely]]
+    {
+        delete task;
+        return;
+    }
+    if (t_pool != this)
+    {
+        m_free_slots.push(slot); // never full: it holds every slot
+        return;
+    }
+    Worker &me = *m_workers[t_worker];
+    if (me.num_free == kCachedSlots)
+        while (me.num_free > kCachedSlots / 2)
+            m_free_slots.push(me.free_slots[--me.num_free]);
+    me.free_slots[me.num_free++] = slot;
+}
+
+inline void ThreadPool::submit(Task *task, Priority priority)
+{
+    // Counted before it is visible, so its start is never counted first
+    count(counts().submitted[static_cast<std::size_t>(priority)]);
+    std::size_t node = 0;
+    if (t_pool == this)
+    {
+        // From one of our workers: keep NORMAL work local, thieves pick it up
+        // if needed; other levels must be visible to every worker's rotation
+        // (inject() keeps this worker busy while their queue is full)
+        Worker &me = *m_workers[t_worker];
+        node = me.node;
+        if (priority != Priority::NORMAL || !me.deque.push(task))
+            inject(task, priority, node);
+    }
+    else
+    {
+        node = current_node();
+        inject(task, priority, node);
+    }
+    wake_one(node);
+}
+
+inline void ThreadPool::inject(Task *task, Priority priority, std::size_t node)
+{
+    // Injection queue full: back off until the workers make room, which
+    // bounds memory and throttles producers. A worker can't wait on itself
+    // (a one-worker pool would hang), so it runs queued work meanwhile
+    while (!m_nodes[node]->injected[static_cast<std::size_t>(priority)].push(task))
+    {
+        if (t_pool == this)
+            if (Taken taken = find_task(t_worker))
+            {
+                run(taken);
+                continue;
+            }
+        wake_one(node);
+        std::this_thread::yield();
+    }
+}
+
+inline ThreadPool::Taken ThreadPool::find_task(std::size_t self)
+{
+    Worker &me = *m_workers[self];
+    // Urgent first, except on the periodic NORMAL / BACKGROUND turns; the
+    // other levels follow in priority order
+    const std::uint32_t turn = me.dispatches + 1;
+    const auto first = turn % kBackgroundEvery == 0 ? Priority::BACKGROUND
+                       : turn % kNormalEvery == 0   ? Priority::NORMAL
+                                                    : Priority::URGENT;
+    std::array<Priority, kPriorityLevels> order{first};
+    for (std::size_t level = 0, next = 1; level < kPriorityLevels; ++level)
+        if (static_cast<Priority>(level) != first)
+            order[next++] = static_cast<Priority>(level);
+
+    for (Priority priority : order)
+    {
+        Task *task = nullptr;
+        if (priority == Priority::NORMAL)
+            if (auto local = me.deque.pop())
+                task = *local;
+        // Random start so idle workers don't all hammer the same victim
+        if (task || (task = take_shared(me.node, priority, me.rng(), self)))
+        {
+            ++me.dispatches;
+            return {task, priority};
+        }
+    }
+    return {};
+}
+
+/// Every level in priority order; for threads that help out in `wait`.
+inline ThreadPool::Taken ThreadPool::take_any(std::size_t node, std::size_t start, std::size_t skip)
+{
+    for (std::size_t level = 0; level < kPriorityLevels; ++level)
+        if (Task *task = take_shared(node, static_cast<Priority>(level), start, skip))
+            return {task, static_cast<Priority>(level)};
+    return {};
+}
+
+/// Per group, starting with `node`: its injection queue for `priority`, then
+/// (NORMAL only, the deques hold nothing else) one steal attempt per worker
+/// except `skip`, from the `start`-th on. Remote groups are only visited once
+/// the local one has nothing.
+inline ThreadPool::Task *ThreadPool::take_shared(std::size_t node, Priority priority, std::size_t start,
+                                                 std::size_t skip)
+{
+    for (std::size_t hop = 0; hop < m_nodes.size(); ++hop)
+    {
+        Node &group = *m_nodes[(node + hop) % m_nodes.size()];
+        Task *task = nullptr;
+        if (group.injected[static_cast<std::size_t>(priority)].pop(task))
+            return task;
+        if (priority != Priority::NORMAL)
+            continue;
+
+        const std::size_t size = group.workers.size();
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            const std::size_t victim = group.workers[(start + i) % size];
+            if (victim == skip)
+                continue;
+            if (auto stolen = m_workers[victim]->deque.steal())
+                return *stolen;
+        }
+    }
+    return nullptr;
+}
+
+inline void ThreadPool::run(Taken taken)
+{
+    Counts &mine = counts();
+    count(mine.started[static_cast<std::size_t>(taken.priority)]);
+    Completion *completion = taken.task->completion;
+    taken.task->run(*taken.task);
+    release_slot(taken.task);
+    if (completion)
+        completion->done();
+    // Pending until it has run: a task may still enqueue more while the pool
+    // drains for shutdown
+    count(mine.completed);
+
+    if (m_stopping.load(std::memory_order_acquire)) [[unlikely]]
+    {
+        // Whichever of two concurrent last runs sums second sees both
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pending() == 0)
+            wake_all(); // lets parked workers exit
+    }
+}
+
+/// The calling thread's counts: its own if it is one of our workers.
+inline ThreadPool::Counts &ThreadPool::counts() noexcept
+{
+    return t_pool == this ? m_workers[t_worker]->counts : m_outside;
+}
+
+/// A worker is the only writer of its counts; outside threads share theirs.
+inline void ThreadPool::count(std::atomic<std::uint64_t> &counter) noexcept
+{
+    if (t_pool == this)
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    else
+        counter.fetch_add(1, std::memory_order_release);
+}
+
+/// `pick(counts)` summed over every thread.
+template <class Pick> std::uint64_t ThreadPool::sum(Pick pick) const noexcept
+{
+    std::uint64_t total = pick(m_outside).load(std::memory_order_acquire);
+    for (const auto &worker : m_workers)
+        total += pick(worker->counts).load(std::memory_order_acquire);
+    return total;
+}
+
+/// Tasks submitted but not yet run. Completions are summed first: each one
+/// counted was submitted before, so the result never underflows, and 0
+/// means nothing was queued or running at some point during the call.
+inline std::uint64_t ThreadPool::pending() const noexcept
+{
+    const std::uint64_t completed = sum([](const Counts &counts) -> auto & { return counts.completed; });
+    std::uint64_t submitted = 0;
+    for (std::size_t level = 0; level < kPriorityLevels; ++level)
+        submitted += sum([level](const Counts &counts) -> auto & { return counts.submitted[level]; });
+    return submitted - completed;
+}
+
+inline void ThreadPool::wake_one(std::size_t node) noexcept
+{
+    // Pairs with the idle store + re-check in worker_loop: either we see the
+    // worker idle, or it sees the task we just published
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_idle_workers.load(std::memory_order_relaxed) == 0)
+        return;
+    // Prefer a worker on the task's node
+    const std::size_t start = m_wake_cursor.fetch_add(1, std::memory_order_relaxed);
+    for (std::size_t hop = 0; hop < m_nodes.size(); ++hop)
+    {
+        const std::vector<std::size_t> &workers = m_nodes[(node + hop) % m_nodes.size()]->workers;
+        for (std::size_t i = 0; i < workers.size(); ++i)
+        {
+            Worker &worker = *m_workers[workers[(start + i) % workers.size()]];
+            bool idle = true;
+            // Claim it, so concurrent submitters wake different workers
+            if (worker.idle.load(std::memory_order_relaxed) &&
+                worker.idle.compare_exchange_strong(idle, false, std::memory_order_acq_rel))
+            {
+                worker.park.notify();
+                return;
+            }
+        }
+    }
+}
+
+inline void ThreadPool::wake_all() noexcept
+{
+    std::ranges::for_each(m_workers, [](auto &worker) { worker->park.notify(); });
+}
+
+inline void ThreadPool::worker_loop(std::size_t self)
+{
+    t_pool = this;
+    t_worker = self;
+    Worker &me = *m_workers[self];
+    auto done = [this] {
+        return m_stopping.load(std::memory_order_acquire) && pending() == 0;
+    };
+    for (;;)
+    {
+        Taken taken = find_task(self);
+        if (!taken)
+        {
+            if (done())
+                return;
+            // Advertise before re-checking (pairs with the fence in wake_one)
+            m_idle_workers.fetch_add(1, std::memory_order_relaxed);
+            me.idle.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // Up on work, on shutdown, or once a submitter claimed us (its
+            // task may have been taken by someone else meanwhile: look again)
+            me.park.wait([&] {
+                return (taken = find_task(self)) || done() || !me.idle.load(std::memory_order_relaxed);
+            });
+            me.idle.store(false, std::memory_order_relaxed);
+            m_idle_workers.fetch_sub(1, std::memory_order_relaxed);
+            if (!taken)
+                continue;
+        }
+        run(taken);
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    m_stopping.store(true, std::memory_order_release);
+    wake_all();
+    // Join every worker before any deque goes away: they steal from each other
+    std::ranges::for_each(m_threads, [](std::jthread &thread) { thread.join(); });
+}
 } // End namespace quick::thread
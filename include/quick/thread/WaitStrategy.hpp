@@ -0,0 +1,209 @@
+#pragma once
+
+// C Includes
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+// C++ Includes
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <concepts>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include <utility>
+
+// QuickLib Includes
+#include "quick/structs/SPSCQueue.hh"
+
+namespace quick::thread
+{
+
+/// @brief How a thread waits for a lock-free queue to become ready.
+/// `wait(ready)` returns once `ready()` (a try-op such as `pop`) has
+/// succeeded; `notify()` is called by the other side after every successful
+/// op and wakes waiters if the strategy ever sleeps. Strategies trade wake-up
+/// latency for CPU burned while idle.
+/// One instance per direction: e.g. the consumer waits on the instance the
+/// producer notifies.
+template <class W>
+concept WaitStrategy = requires(W wait, bool (*ready)()) {
+    wait.wait(ready);
+    wait.notify();
+};
+
+/// @brief Lowest latency, burns a full core while idle.
+struct BusySpinWait
+{
+    template <class Ready> void wait(Ready &&ready)
+    {
+        while (!ready())
+        {
+        }
+    }
+
+    void notify() noexcept
+    {
+    }
+};
+
+/// @brief Spins with `_mm_pause`: frees pipeline resources for the sibling
+/// hyperthread and cuts power, at a few dozen cycles of extra latency.
+struct SpinPauseWait
+{
+    template <class Ready> void wait(Ready &&ready)
+    {
+        while (!ready())
+            _mm_pause();
+    }
+
+    void notify() noexcept
+    {
+    }
+};
+
+/// @brief Pauses for `spins` attempts, then yields the CPU between attempts.
+/// Good for threads that share cores with other work.
+struct SpinYieldWait
+{
+    std::uint32_t spins{1024};
+
+    template <class Ready> void wait(Ready &&ready)
+    {
+        for (std::uint32_t i = 0; !ready(); ++i)
+        {
+            if (i < spins)
+                _mm_pause();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    void notify() noexcept
+    {
+    }
+};
+
+/// @brief Pauses for `spins` attempts, then sleeps on a futex until notified.
+/// Idle threads cost nothing; the first message after a sleep pays a
+/// wake-up (microseconds). Also supports timed waits (`wait_for`).
+///
+/// The futex word is an epoch with a "someone is asleep" flag in bit 0.
+/// `notify()` is a fence and a load while the flag is clear; otherwise it
+/// clears the flag, bumps the epoch and wakes every sleeper, and sleepers
+/// that still find nothing to do set the flag again. So a burst of notifies
+/// costs one syscall per round of sleepers, not one per notify.
+class SpinBlockWait
+{
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) &&
+                  std::atomic<std::uint32_t>::is_always_lock_free);
+    static constexpr std::uint32_t kSleeping = 1;
+    static constexpr std::uint32_t kEpochStep = 2;
+
+    alignas(quick::structs::cacheline_t::value) std::atomic<std::uint32_t> m_word{0};
+
+    std::uint32_t *futex_word() noexcept
+    {
+        return reinterpret_cast<std::uint32_t *>(&m_word);
+    }
+
+    // One sleep, bounded by `timeout` if given. Returns ready()'s verdict.
+    template <class Ready> bool sleep_once(Ready &ready, const ::timespec *timeout)
+    {
+        // Raise the flag before the last check. Paired with the fence in
+        // notify(): either the notifier sees the flag, or we see its data.
+        const std::uint32_t word = m_word.fetch_or(kSleeping, std::memory_order_seq_cst) | kSleeping;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready())
+            return true;
+        // Returns at once if a notify changed the word since the fetch_or
+        ::syscall(SYS_futex, futex_word(), FUTEX_WAIT_PRIVATE, word, timeout, nullptr, 0);
+        return ready();
+    }
+
+    template <class Ready> bool spin(Ready &ready)
+    {
+        for (std::uint32_t i = 0; i < spins; ++i)
+        {
+            if (ready())
+                return true;
+            _mm_pause();
+        }
+        return false;
+    }
+
+  public:
+    std::uint32_t spins{1024};
+
+    SpinBlockWait() noexcept = default;
+    explicit SpinBlockWait(std::uint32_t spin_count) noexcept : spins{spin_count}
+    {
+    }
+
+    template <class Ready> void wait(Ready &&ready)
+    {
+        if (spin(ready))
+            return;
+        while (!sleep_once(ready, nullptr))
+        {
+        }
+    }
+
+    /// @brief Like `wait`, but gives up after `timeout`.
+    /// @return Whether `ready()` succeeded
+    template <class Ready, class Rep, class Period>
+    bool wait_for(Ready &&ready, std::chrono::duration<Rep, Period> timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        if (spin(ready))
+            return true;
+        for (;;)
+        {
+            const auto left = deadline - std::chrono::steady_clock::now();
+            if (left <= std::chrono::steady_clock::duration::zero())
+                return ready();
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+            const ::timespec rel{static_cast<::time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000)};
+            if (sleep_once(ready, &rel))
+                return true;
+        }
+    }
+
+    /// @brief Wakes every sleeper, if there are any.
+    void notify() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint32_t word = m_word.load(std::memory_order_relaxed);
+        while (word & kSleeping)
+        {
+            if (m_word.compare_exchange_weak(word, (word + kEpochStep) & ~kSleeping, std::memory_order_relaxed))
+            {
+                ::syscall(SYS_futex, futex_word(), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+                return;
+            }
+        }
+    }
+};
+
+/// @brief Pops from any queue with `bool pop(T&)`, waiting per `wait` while
+/// it is empty. The producer must `notify()` the same strategy after pushing.
+template <class Queue, class T, WaitStrategy Wait> void pop_wait(Queue &queue, T &out, Wait &wait)
+{
+    wait.wait([&] { return queue.pop(out); });
+}
+
+/// @brief Pushes into any queue with `bool push(T)`, waiting per `wait` while
+/// it is full. The consumer must `notify()` the same strategy after popping.
+template <class Queue, class T, WaitStrategy Wait> void push_wait(Queue &queue, T &&value, Wait &wait)
+{
+    // A failed push leaves `value` untouched, so retrying with it is safe
+    wait.wait([&] { return queue.push(std::forward<T>(value)); });
+}
+
+static_assert(WaitStrategy<BusySpinWait> && WaitStrategy<SpinPauseWait> && WaitStrategy<SpinYieldWait> &&
+              WaitStrategy<SpinBlockWait>);
+
+} // End namespace quick::thread
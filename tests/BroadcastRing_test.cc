@@ -0,0 +1,83 @@
+// clang-format on
+#include "quick/structs/BroadcastRing.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+// clang-format off
+
+TEST(BroadcastRingTest, SlowestConsumerGatesProducer)
+{
+    quick::structs::BroadcastRing<int, 4UL> ring{2};
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(ring.try_publish(i));
+    EXPECT_FALSE(ring.try_publish(4)) << "both consumers are a ring behind";
+
+    std::vector<int> fast;
+    EXPECT_EQ(ring.poll(0, [&](const int &x) { fast.push_back(x); }), 4U);
+    EXPECT_FALSE(ring.try_publish(4)) << "consumer 1 still holds every slot";
+    EXPECT_EQ(ring.lag(1), 4U);
+
+    std::vector<int> slow;
+    EXPECT_EQ(ring.poll(1, [&](const int &x) { slow.push_back(x); }, 1), 1U);
+    ASSERT_TRUE(ring.try_publish(4));
+    EXPECT_EQ(ring.poll(1, [&](const int &x) { slow.push_back(x); }), 4U);
+    EXPECT_EQ(ring.poll(0, [&](const int &x) { fast.push_back(x); }), 1U);
+
+    EXPECT_EQ(fast, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_EQ(slow, fast);
+    EXPECT_EQ(ring.poll(0, [](const int &) {}), 0U);
+}
+
+TEST(BroadcastRingTest, ClaimWritesInPlace)
+{
+    quick::structs::BroadcastRing<std::vector<int>, 2UL> ring{1};
+    std::vector<int> *slot = ring.claim();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(ring.claim(), slot);
+    slot->assign({1, 2, 3});
+    ring.publish();
+
+    const std::vector<int> *seen = nullptr;
+    ring.poll(0, [&](const std::vector<int> &msg) { seen = &msg; });
+    EXPECT_EQ(seen, slot) << "consumers read the producer's slot, no copy";
+}
+
+TEST(BroadcastRingTest, EveryConsumerSeesEveryMessageInOrder)
+{
+    constexpr std::size_t kConsumers = 3;
+    constexpr std::uint64_t kMessages = 100'000;
+    quick::structs::BroadcastRing<std::uint64_t, 64UL> ring{kConsumers};
+
+    std::vector<std::jthread> consumers;
+    std::vector<std::uint64_t> received(kConsumers, 0);
+    std::vector<char> ordered(kConsumers, 1); // not vector<bool>: its bits share words across threads
+    for (std::size_t c = 0; c < kConsumers; ++c)
+        consumers.emplace_back([&, c] {
+            std::uint64_t expected = 0;
+            while (expected < kMessages)
+            {
+                const std::size_t n = ring.poll(c, [&](const std::uint64_t &x) {
+                    if (x != expected)
+                        ordered[c] = 0;
+                    ++expected;
+                });
+                if (n == 0)
+                    std::this_thread::yield();
+            }
+            received[c] = expected;
+        });
+
+    for (std::uint64_t i = 0; i < kMessages; ++i)
+        while (!ring.try_publish(i))
+            std::this_thread::yield();
+    consumers.clear();
+
+    for (std::size_t c = 0; c < kConsumers; ++c)
+    {
+        EXPECT_EQ(received[c], kMessages) << "consumer " << c;
+        EXPECT_EQ(ordered[c], 1) << "consumer " << c;
+    }
+}
@@ -0,0 +1,60 @@
+// clang-format on
+#include "quick/structs/FlatHashMap.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "quick/utils/XorBitant.hh"
+// clang-format off
+
+TEST(FlatHashMapTest, InsertFindErase)
+{
+    quick::structs::FlatHashMap<std::uint64_t, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.insert(7, 70));
+    EXPECT_FALSE(map.insert(7, 71));
+    ASSERT_NE(map.find(7), nullptr);
+    EXPECT_EQ(*map.find(7), 70);
+    EXPECT_EQ(map.find(8), nullptr);
+
+    EXPECT_TRUE(map.erase(7));
+    EXPECT_FALSE(map.erase(7));
+    EXPECT_FALSE(map.contains(7));
+    EXPECT_EQ(map.size(), 0);
+}
+
+TEST(FlatHashMapTest, ReserveAvoidsRehash)
+{
+    quick::structs::FlatHashMap<std::uint64_t, int> map{1000};
+    const auto capacity = map.capacity();
+    for (std::uint64_t i = 0; i < 1000; ++i)
+        EXPECT_TRUE(map.insert(i, static_cast<int>(i)));
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderChurn)
+{
+    XorBitant rng{7};
+    quick::structs::FlatHashMap<std::uint64_t, std::uint64_t> map;
+    std::unordered_map<std::uint64_t, std::uint64_t> reference;
+
+    for (int i = 0; i < 200'000; ++i)
+    {
+        const std::uint64_t key = rng() % 4096;
+        if (rng() % 3 == 0)
+        {
+            EXPECT_EQ(map.erase(key), reference.erase(key) == 1);
+            continue;
+        }
+        EXPECT_EQ(map.insert(key, i), reference.emplace(key, i).second);
+    }
+
+    EXPECT_EQ(map.size(), reference.size());
+    for (auto [key, value] : reference)
+    {
+        ASSERT_NE(map.find(key), nullptr);
+        EXPECT_EQ(*map.find(key), value);
+    }
+}
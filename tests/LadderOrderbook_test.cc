@@ -0,0 +1,479 @@
+// clang-format on
+#include "quick/structs/LadderOrderbook.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <map>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "quick/structs/SPSCQueue.hh"
+#include "quick/structs/TickBitmap.hh"
+#include "quick/utils/XorBitant.hh"
+// clang-format off
+
+namespace
+{
+bool operator==(const Trade &a, const Trade &b)
+{
+    return a.OrderIdA == b.OrderIdA && a.OrderIdB == b.OrderIdB && a.AggressorOrderId == b.AggressorOrderId &&
+           a.AggressorIsBuy == b.AggressorIsBuy && a.Level == b.Level && a.Size == b.Size;
+}
+} // namespace
+
+TEST(TickBitmapTest, MinMaxNextPrev)
+{
+    quick::structs::TickBitmap ticks{100'000};
+    EXPECT_TRUE(ticks.empty());
+    EXPECT_EQ(ticks.max(), quick::structs::TickBitmap::npos);
+    EXPECT_EQ(ticks.min(), quick::structs::TickBitmap::npos);
+
+    for (std::size_t i : {7UL, 64UL, 4095UL, 4096UL, 99'999UL})
+        ticks.set(i);
+
+    EXPECT_EQ(ticks.min(), 7);
+    EXPECT_EQ(ticks.max(), 99'999);
+    EXPECT_EQ(ticks.next(8), 64);
+    EXPECT_EQ(ticks.next(4096), 4096);
+    EXPECT_EQ(ticks.next(4097), 99'999);
+    EXPECT_EQ(ticks.prev(4094), 64);
+    EXPECT_EQ(ticks.prev(6), quick::structs::TickBitmap::npos);
+
+    ticks.clear(99'999);
+    ticks.clear(7);
+    EXPECT_EQ(ticks.min(), 64);
+    EXPECT_EQ(ticks.max(), 4096);
+    EXPECT_FALSE(ticks.test(7));
+    EXPECT_TRUE(ticks.test(4095));
+}
+
+template <class Book> class OrderbookEngineTest : public ::testing::Test
+{
+  protected:
+    Book book_{};
+};
+
+using Engines = ::testing::Types<Orderbook, LadderOrderbook>;
+TYPED_TEST_SUITE(OrderbookEngineTest, Engines);
+
+TYPED_TEST(OrderbookEngineTest, RestsAndReportsBestPrices)
+{
+    EXPECT_TRUE(this->book_.AddOrder(Order{1, 100, true, 5}).empty());
+    EXPECT_TRUE(this->book_.AddOrder(Order{2, 101, true, 5}).empty());
+    EXPECT_TRUE(this->book_.AddOrder(Order{3, 105, false, 5}).empty());
+    EXPECT_TRUE(this->book_.AddOrder(Order{4, 103, false, 5}).empty());
+
+    EXPECT_EQ(this->book_.best_bid(), 101);
+    EXPECT_EQ(this->book_.best_ask(), 103);
+}
+
+TYPED_TEST(OrderbookEngineTest, MatchesInPriceTimePriority)
+{
+    (void)this->book_.AddOrder(Order{1, 100, false, 3});
+    (void)this->book_.AddOrder(Order{2, 100, false, 3});
+    (void)this->book_.AddOrder(Order{3, 99, false, 2});
+
+    Trades trades = this->book_.AddOrder(Order{10, 100, true, 6});
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_TRUE((trades[0] == Trade{10, 3, 10, true, 99, 2}));
+    EXPECT_TRUE((trades[1] == Trade{10, 1, 10, true, 100, 3}));
+    EXPECT_TRUE((trades[2] == Trade{10, 2, 10, true, 100, 1}));
+    EXPECT_EQ(this->book_.best_ask(), 100);
+    EXPECT_EQ(this->book_.best_bid(), std::nullopt);
+}
+
+TYPED_TEST(OrderbookEngineTest, RejectsDupesAndCancels)
+{
+    (void)this->book_.AddOrder(Order{1, 100, true, 5});
+    (void)this->book_.AddOrder(Order{1, 90, false, 5});
+    EXPECT_EQ(this->book_.best_ask(), std::nullopt);
+
+    this->book_.CancelOrder(1);
+    EXPECT_EQ(this->book_.best_bid(), std::nullopt);
+    EXPECT_TRUE(this->book_.AddOrder(Order{2, 90, false, 5}).empty());
+}
+
+TYPED_TEST(OrderbookEngineTest, ReduceKeepsQueuePriority)
+{
+    (void)this->book_.AddOrder(Order{1, 100, false, 5});
+    (void)this->book_.AddOrder(Order{2, 100, false, 5});
+    this->book_.ReduceOrder(1, 3);
+
+    Trades trades = this->book_.AddOrder(Order{10, 100, true, 4});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_TRUE((trades[0] == Trade{10, 1, 10, true, 100, 2}));
+    EXPECT_TRUE((trades[1] == Trade{10, 2, 10, true, 100, 2}));
+
+    this->book_.ReduceOrder(2, 3);
+    EXPECT_EQ(this->book_.best_ask(), std::nullopt);
+}
+
+TYPED_TEST(OrderbookEngineTest, ReduceIgnoresNonPositiveAmounts)
+{
+    (void)this->book_.AddOrder(Order{1, 100, false, 5});
+    (void)this->book_.AddOrder(Order{2, 100, false, 5});
+    this->book_.ReduceOrder(1, 0);
+    this->book_.ReduceOrder(1, -3); // would make it 8 and keep the front
+
+    Trades trades = this->book_.AddOrder(Order{10, 100, true, 8});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_TRUE((trades[0] == Trade{10, 1, 10, true, 100, 5}));
+    EXPECT_TRUE((trades[1] == Trade{10, 2, 10, true, 100, 3}));
+}
+
+TYPED_TEST(OrderbookEngineTest, ModifyDownKeepsPriorityUpRequeues)
+{
+    (void)this->book_.AddOrder(Order{1, 100, false, 5});
+    (void)this->book_.AddOrder(Order{2, 100, false, 5});
+    (void)this->book_.AddOrder(Order{3, 100, false, 5});
+
+    EXPECT_TRUE(this->book_.ModifyOrder(1, 100, 4).empty()); // keeps the front
+    EXPECT_TRUE(this->book_.ModifyOrder(2, 100, 6).empty()); // goes behind 3
+
+    Trades trades = this->book_.AddOrder(Order{10, 100, true, 15});
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_TRUE((trades[0] == Trade{10, 1, 10, true, 100, 4}));
+    EXPECT_TRUE((trades[1] == Trade{10, 3, 10, true, 100, 5}));
+    EXPECT_TRUE((trades[2] == Trade{10, 2, 10, true, 100, 6}));
+}
+
+TYPED_TEST(OrderbookEngineTest, ModifyPriceCanCross)
+{
+    (void)this->book_.AddOrder(Order{1, 100, true, 5});
+    (void)this->book_.AddOrder(Order{2, 103, false, 3});
+
+    Trades trades = this->book_.ModifyOrder(1, 103, 5);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_TRUE((trades[0] == Trade{1, 2, 1, true, 103, 3}));
+    EXPECT_EQ(this->book_.best_bid(), 103);
+    EXPECT_EQ(this->book_.best_ask(), std::nullopt);
+
+    EXPECT_TRUE(this->book_.ModifyOrder(42, 100, 1).empty());
+    EXPECT_TRUE(this->book_.ModifyOrder(1, 103, 0).empty());
+    EXPECT_EQ(this->book_.best_bid(), std::nullopt);
+}
+
+TYPED_TEST(OrderbookEngineTest, CancelFromMiddleOfLevel)
+{
+    for (Id id = 1; id <= 4; ++id)
+        (void)this->book_.AddOrder(Order{id, 100, true, 1});
+    this->book_.CancelOrder(1);
+    this->book_.CancelOrder(3);
+
+    Trades trades = this->book_.AddOrder(Order{10, 100, false, 5});
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].OrderIdA, 2);
+    EXPECT_EQ(trades[1].OrderIdA, 4);
+    EXPECT_EQ(this->book_.best_ask(), 100);
+}
+
+TYPED_TEST(OrderbookEngineTest, SinkOverloadsEmitSameTrades)
+{
+    TypeParam reference;
+    for (Id id = 1; id <= 6; ++id)
+    {
+        (void)reference.AddOrder(Order{id, static_cast<Price>(100 + id), false, 2});
+        (void)this->book_.AddOrder(Order{id, static_cast<Price>(100 + id), false, 2});
+    }
+    Trades expected = reference.AddOrder(Order{10, 104, true, 7});
+
+    std::array<Trade, 2> storage{};
+    TradeBuffer buffer{storage};
+    EXPECT_EQ(this->book_.AddOrder(Order{10, 104, true, 1}, buffer), 1);
+    quick::structs::SPSCQueue<Trade, 8> queue;
+    QueueTradeSink sink{queue};
+    EXPECT_EQ(this->book_.AddOrder(Order{11, 104, true, 6}, sink), 4);
+
+    ASSERT_EQ(expected.size(), 4);
+    ASSERT_EQ(buffer.trades().size(), 1);
+    EXPECT_EQ(buffer.trades()[0].OrderIdB, expected[0].OrderIdB);
+    EXPECT_EQ(buffer.trades()[0].Size, 1);
+    Trade trade{};
+    ASSERT_TRUE(queue.pop(trade));
+    EXPECT_EQ(trade.OrderIdB, expected[0].OrderIdB);
+    EXPECT_EQ(trade.Size, 1);
+    for (std::size_t i = 1; i < expected.size(); ++i)
+    {
+        ASSERT_TRUE(queue.pop(trade));
+        EXPECT_EQ(trade.OrderIdB, expected[i].OrderIdB);
+        EXPECT_EQ(trade.Size, expected[i].Size);
+    }
+}
+
+TEST(LadderOrderbookTest, TradeBufferOverflowIsFatal)
+{
+    LadderOrderbook book;
+    for (Id id = 1; id <= 3; ++id)
+        (void)book.AddOrder(Order{id, 100, false, 1});
+
+    std::array<Trade, 2> storage{};
+    TradeBuffer buffer{storage};
+    EXPECT_DEBUG_DEATH((void)book.AddOrder(Order{10, 100, true, 3}, buffer), "too small");
+}
+
+// A full queue holds the matcher back until the consumer catches up
+TEST(LadderOrderbookTest, QueueTradeSinkNeverDrops)
+{
+    constexpr Id kResting = 64;
+    LadderOrderbook book;
+    for (Id id = 1; id <= kResting; ++id)
+        (void)book.AddOrder(Order{id, 100, false, 1});
+
+    quick::structs::SPSCQueue<Trade, 4> queue;
+    std::vector<Trade> received;
+    std::jthread consumer{[&] {
+        Trade trade{};
+        while (received.size() < kResting)
+        {
+            if (queue.pop(trade))
+                received.push_back(trade);
+            else
+                std::this_thread::yield();
+        }
+    }};
+    QueueTradeSink sink{queue};
+    EXPECT_EQ(book.AddOrder(Order{kResting + 1, 100, true, static_cast<Quantity>(kResting)}, sink), kResting);
+    consumer.join();
+
+    ASSERT_EQ(received.size(), kResting);
+    for (std::size_t i = 0; i < received.size(); ++i)
+        EXPECT_EQ(received[i].OrderIdB, static_cast<Id>(i + 1));
+}
+
+TEST(LadderOrderbookTest, ReportsPoolExhaustion)
+{
+    LadderOrderbook book{0, 200, 2};
+    auto ignore = [](const Trade &) {};
+    EXPECT_TRUE(book.TryAddOrder(Order{1, 100, true, 1}, ignore).has_value());
+    EXPECT_TRUE(book.TryAddOrder(Order{2, 101, true, 1}, ignore).has_value());
+
+    auto full = book.TryAddOrder(Order{3, 99, true, 1}, ignore);
+    ASSERT_FALSE(full.has_value());
+    EXPECT_EQ(full.error(), quick::error::OrderbookError::POOL_EXHAUSTED);
+    EXPECT_EQ(book.resting_orders(), 2);
+
+    // A crossing order still trades against the full book, and frees a slot
+    auto fill = book.TryAddOrder(Order{4, 101, false, 1}, ignore);
+    ASSERT_TRUE(fill.has_value());
+    EXPECT_EQ(*fill, 1);
+    EXPECT_EQ(book.resting_orders(), 1);
+    EXPECT_EQ(book.best_bid(), 100);
+
+    EXPECT_TRUE(book.TryAddOrder(Order{5, 150, false, 1}, ignore).has_value());
+    auto dupe = book.TryAddOrder(Order{5, 150, false, 1}, ignore);
+    ASSERT_FALSE(dupe.has_value());
+    EXPECT_EQ(dupe.error(), quick::error::OrderbookError::DUPLICATE_ORDER_ID);
+    EXPECT_EQ(book.TryAddOrder(Order{6, 201, false, 1}, ignore).error(),
+              quick::error::OrderbookError::PRICE_OUT_OF_RANGE);
+}
+
+TYPED_TEST(OrderbookEngineTest, DepthSnapshotAggregatesLevels)
+{
+    (void)this->book_.AddOrder(Order{1, 100, true, 5});
+    (void)this->book_.AddOrder(Order{2, 100, true, 7});
+    (void)this->book_.AddOrder(Order{3, 98, true, 1});
+    (void)this->book_.AddOrder(Order{4, 97, true, 2});
+    (void)this->book_.AddOrder(Order{5, 101, false, 3});
+
+    std::array<DepthLevel, 2> bids{};
+    ASSERT_EQ(this->book_.DepthSnapshot(true, bids), 2);
+    EXPECT_EQ(bids[0].level, 100);
+    EXPECT_EQ(bids[0].qty, 12);
+    EXPECT_EQ(bids[0].orders, 2);
+    EXPECT_EQ(bids[1].level, 98);
+
+    std::array<DepthLevel, 4> asks{};
+    ASSERT_EQ(this->book_.DepthSnapshot(false, asks), 1);
+    EXPECT_EQ(asks[0].level, 101);
+    EXPECT_EQ(asks[0].qty, 3);
+}
+
+TEST(LadderOrderbookTest, PublishesCoalescedDepthUpdates)
+{
+    LadderOrderbook book;
+    for (Id id = 1; id <= 4; ++id)
+        (void)book.AddOrder(Order{id, 100, false, 2});
+    (void)book.AddOrder(Order{5, 101, false, 2});
+
+    std::vector<DepthUpdate> updates;
+    auto collect = [&](const DepthUpdate &update) { updates.push_back(update); };
+    EXPECT_EQ(book.PublishDepthUpdates(collect), 2);
+    EXPECT_EQ(book.PublishDepthUpdates(collect), 0);
+
+    // One sweep through four orders at 100 and into 101: one update per level
+    updates.clear();
+    (void)book.AddOrder(Order{10, 101, true, 9});
+    ASSERT_EQ(book.PublishDepthUpdates(collect), 2);
+    EXPECT_FALSE(updates[0].is_buy);
+    EXPECT_EQ(updates[0].depth.level, 100);
+    EXPECT_EQ(updates[0].depth.orders, 0);
+    EXPECT_EQ(updates[1].depth.level, 101);
+    EXPECT_EQ(updates[1].depth.qty, 1);
+    EXPECT_EQ(updates[1].depth.orders, 1);
+}
+
+TEST(LadderOrderbookTest, DepthUpdatesRebuildVectorBookDepth)
+{
+    XorBitant rng{99};
+    Orderbook reference;
+    LadderOrderbook ladder{0, 1023};
+    std::map<std::pair<bool, Price>, DepthLevel> mirror;
+    auto apply = [&](const DepthUpdate &update) {
+        if (update.depth.orders == 0)
+            mirror.erase({update.is_buy, update.depth.level});
+        else
+            mirror[{update.is_buy, update.depth.level}] = update.depth;
+    };
+
+    for (Id id = 1; id < 5'000; ++id)
+    {
+        const auto roll = rng() % 10;
+        if (roll == 0)
+        {
+            Id victim = 1 + rng() % id;
+            reference.CancelOrder(victim);
+            ladder.CancelOrder(victim);
+        }
+        else if (roll == 1)
+        {
+            Id victim = 1 + rng() % id;
+            Quantity by = static_cast<Quantity>(1 + rng() % 10);
+            reference.ReduceOrder(victim, by);
+            ladder.ReduceOrder(victim, by);
+        }
+        else
+        {
+            Order order{id, static_cast<Price>(480 + rng() % 40), (rng() & 1U) != 0,
+                        static_cast<Quantity>(1 + rng() % 20)};
+            (void)reference.AddOrder(order);
+            (void)ladder.AddOrder(order);
+        }
+        ladder.PublishDepthUpdates(apply);
+    }
+
+    for (bool is_buy : {true, false})
+    {
+        std::array<DepthLevel, 64> expected{};
+        const std::size_t n = reference.DepthSnapshot(is_buy, expected);
+        std::size_t in_mirror = 0;
+        for (auto &[key, depth] : mirror)
+            in_mirror += key.first == is_buy;
+        ASSERT_EQ(n, in_mirror);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto it = mirror.find({is_buy, expected[i].level});
+            ASSERT_NE(it, mirror.end());
+            EXPECT_EQ(it->second.qty, expected[i].qty);
+            EXPECT_EQ(it->second.orders, expected[i].orders);
+        }
+    }
+}
+
+TEST(LadderOrderbookTest, RejectsOutOfRangePrices)
+{
+    LadderOrderbook book{100, 200};
+    EXPECT_TRUE(book.AddOrder(Order{1, 201, true, 1}).empty());
+    EXPECT_TRUE(book.AddOrder(Order{2, 99, false, 1}).empty());
+    EXPECT_EQ(book.best_bid(), std::nullopt);
+    EXPECT_EQ(book.best_ask(), std::nullopt);
+}
+
+TEST(LadderOrderbookTest, MatchesVectorOrderbookOnRandomFlow)
+{
+    XorBitant rng{42};
+    Orderbook reference;
+    LadderOrderbook ladder{0, 1023};
+
+    for (Id id = 1; id < 20'000; ++id)
+    {
+        if (rng() % 9 == 0)
+        {
+            Id victim = 1 + rng() % id;
+            Price level = static_cast<Price>(450 + rng() % 100);
+            Quantity qty = static_cast<Quantity>(rng() % 50);
+            Trades expected = reference.ModifyOrder(victim, level, qty);
+            Trades actual = ladder.ModifyOrder(victim, level, qty);
+            ASSERT_EQ(expected.size(), actual.size()) << "modify " << victim;
+            for (std::size_t i = 0; i < expected.size(); ++i)
+                ASSERT_TRUE(expected[i] == actual[i]) << "modify " << victim << " trade " << i;
+            ASSERT_EQ(reference.best_bid(), ladder.best_bid()) << "modify " << victim;
+            ASSERT_EQ(reference.best_ask(), ladder.best_ask()) << "modify " << victim;
+            continue;
+        }
+        if (rng() % 7 == 0)
+        {
+            Id victim = 1 + rng() % id;
+            Quantity by = static_cast<Quantity>(1 + rng() % 20);
+            reference.ReduceOrder(victim, by);
+            ladder.ReduceOrder(victim, by);
+            continue;
+        }
+        if (rng() % 5 == 0)
+        {
+            Id victim = 1 + rng() % id;
+            reference.CancelOrder(victim);
+            ladder.CancelOrder(victim);
+            continue;
+        }
+        Order order{id, static_cast<Price>(450 + rng() % 100), (rng() & 1U) != 0, static_cast<Quantity>(1 + rng() % 50)};
+        Trades expected = reference.AddOrder(order);
+        Trades actual = ladder.AddOrder(order);
+        ASSERT_EQ(expected.size(), actual.size()) << "order " << id;
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            ASSERT_TRUE(expected[i] == actual[i]) << "order " << id << " trade " << i;
+        ASSERT_EQ(reference.best_bid(), ladder.best_bid());
+        ASSERT_EQ(reference.best_ask(), ladder.best_ask());
+    }
+}
+
+TYPED_TEST(OrderbookEngineTest, ApplyBatchMatchesSequentialCalls)
+{
+    XorBitant rng{7};
+    std::vector<OrderCommand> commands;
+    for (Id id = 1; id < 10'000; ++id)
+    {
+        const Id victim = 1 + rng() % id;
+        switch (rng() % 8)
+        {
+        case 0:
+            commands.push_back(OrderCommand::cancel(victim));
+            break;
+        case 1:
+            commands.push_back(OrderCommand::reduce(victim, static_cast<Quantity>(1 + rng() % 20)));
+            break;
+        case 2:
+            commands.push_back(
+                OrderCommand::modify(victim, static_cast<Price>(450 + rng() % 100), static_cast<Quantity>(rng() % 50)));
+            break;
+        default:
+            commands.push_back(OrderCommand::add(Order{id, static_cast<Price>(450 + rng() % 100), (rng() & 1U) != 0,
+                                                       static_cast<Quantity>(1 + rng() % 50)}));
+        }
+    }
+
+    Orderbook reference;
+    Trades expected;
+    for (const OrderCommand &command : commands)
+        ApplyCommand(reference, command, [&](const Trade &trade) { expected.push_back(trade); });
+
+    TypeParam book;
+    Trades actual;
+    std::size_t n_trades = 0;
+    // Uneven chunks so batch boundaries land mid-stream
+    for (std::size_t begin = 0; begin < commands.size(); begin += 613)
+    {
+        const std::size_t len = std::min<std::size_t>(613, commands.size() - begin);
+        n_trades += ApplyBatch(book, std::span<const OrderCommand>{commands}.subspan(begin, len), actual);
+    }
+
+    ASSERT_EQ(n_trades, actual.size());
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+        ASSERT_TRUE(expected[i] == actual[i]) << "trade " << i;
+    EXPECT_EQ(reference.best_bid(), book.best_bid());
+    EXPECT_EQ(reference.best_ask(), book.best_ask());
+}
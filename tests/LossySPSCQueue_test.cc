@@ -0,0 +1,74 @@
+// clang-format on
+#include "quick/structs/LossySPSCQueue.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+// clang-format off
+
+TEST(LossySPSCQueueTest, OverwritesOldestAndCountsMisses)
+{
+    quick::structs::LossySPSCQueue<int, 4UL> queue;
+    int out = 0;
+    EXPECT_FALSE(queue.pop(out));
+
+    for (int i = 0; i < 10; ++i)
+        queue.push(i);
+
+    for (int expected = 6; expected < 10; ++expected)
+    {
+        ASSERT_TRUE(queue.pop(out));
+        EXPECT_EQ(out, expected);
+    }
+    EXPECT_FALSE(queue.pop(out));
+    EXPECT_EQ(queue.missed(), 6U);
+
+    // Back to lossless while the consumer keeps up
+    queue.push(42);
+    ASSERT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 42);
+    EXPECT_EQ(queue.missed(), 6U);
+}
+
+TEST(LossySPSCQueueTest, ConcurrentReadsAreNeverTorn)
+{
+    struct Tick
+    {
+        std::uint64_t seq;
+        std::uint64_t check; // ~seq, to catch torn copies
+    };
+    quick::structs::LossySPSCQueue<Tick, 16UL> queue;
+    constexpr std::uint64_t kTicks = 500'000;
+
+    std::jthread producer{[&] {
+        for (std::uint64_t i = 0; i < kTicks; ++i)
+        {
+            queue.push(Tick{i, ~i});
+            if (i % 64 == 0)
+                std::this_thread::yield();
+        }
+    }};
+
+    std::uint64_t received = 0;
+    std::uint64_t last = 0;
+    Tick tick{};
+    while (received + queue.missed() < kTicks)
+    {
+        if (!queue.pop(tick))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(tick.check, ~tick.seq);
+        if (received > 0)
+        {
+            ASSERT_GT(tick.seq, last);
+        }
+        last = tick.seq;
+        ++received;
+    }
+    producer.join();
+    EXPECT_EQ(received + queue.missed(), kTicks);
+    EXPECT_EQ(last, kTicks - 1);
+}
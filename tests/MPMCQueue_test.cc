@@ -0,0 +1,76 @@
+// clang-format on
+#include "quick/structs/MPMCQueue.hh"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+// clang-format off
+
+TEST(MPMCQueueTest, FillsDrainsAndWraps)
+{
+    quick::structs::MPMCQueue<std::string, 4UL> queue;
+    std::string out;
+    EXPECT_FALSE(queue.pop(out));
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 4; ++i)
+            ASSERT_TRUE(queue.push(std::to_string(i)));
+        EXPECT_FALSE(queue.push("full"));
+        EXPECT_EQ(queue.size(), 4U);
+        for (int i = 0; i < 4; ++i)
+        {
+            ASSERT_TRUE(queue.pop(out));
+            EXPECT_EQ(out, std::to_string(i));
+        }
+        EXPECT_TRUE(queue.empty());
+    }
+    // Left non-empty on purpose: the destructor must clean up
+    ASSERT_TRUE(queue.emplace(3, 'x'));
+}
+
+TEST(MPMCQueueTest, DeliversEveryElementExactlyOnce)
+{
+    constexpr std::uint64_t kProducers = 4;
+    constexpr std::uint64_t kConsumers = 4;
+    constexpr std::uint64_t kPerProducer = 50'000;
+    constexpr std::uint64_t kTotal = kProducers * kPerProducer;
+
+    quick::structs::MPMCQueue<std::uint64_t, 64UL> queue;
+    auto seen = std::make_unique<std::atomic<std::uint8_t>[]>(kTotal);
+    std::atomic<std::uint64_t> consumed{0};
+
+    {
+        std::vector<std::jthread> threads;
+        for (std::uint64_t p = 0; p < kProducers; ++p)
+            threads.emplace_back([&, p] {
+                for (std::uint64_t i = 0; i < kPerProducer; ++i)
+                    while (!queue.push(p * kPerProducer + i))
+                        std::this_thread::yield();
+            });
+        for (std::uint64_t c = 0; c < kConsumers; ++c)
+            threads.emplace_back([&] {
+                std::uint64_t value = 0;
+                while (consumed.load(std::memory_order_relaxed) < kTotal)
+                {
+                    if (!queue.pop(value))
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    seen[value].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+    }
+
+    EXPECT_EQ(consumed.load(), kTotal);
+    for (std::uint64_t i = 0; i < kTotal; ++i)
+        ASSERT_EQ(seen[i].load(), 1U) << "value " << i;
+    EXPECT_TRUE(queue.empty());
+}
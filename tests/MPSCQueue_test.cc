@@ -0,0 +1,84 @@
+// clang-format on
+#include "quick/structs/MPSCQueue.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+// clang-format off
+
+namespace
+{
+struct Event : quick::structs::MPSCHook
+{
+    std::uint32_t producer{0};
+    std::uint64_t seq{0};
+};
+} // namespace
+
+TEST(MPSCQueueTest, FifoAndBatchDrain)
+{
+    quick::structs::MPSCQueue<Event> queue;
+    std::vector<Event> events(10);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    for (std::uint64_t i = 0; i < events.size(); ++i)
+    {
+        events[i].seq = i;
+        queue.push(&events[i]);
+    }
+    EXPECT_FALSE(queue.empty());
+
+    std::vector<std::uint64_t> seen;
+    EXPECT_EQ(queue.drain([&](Event *e) { seen.push_back(e->seq); }, 4), 4U);
+    EXPECT_EQ(queue.drain([&](Event *e) { seen.push_back(e->seq); }), 6U);
+    ASSERT_EQ(seen.size(), 10U);
+    for (std::uint64_t i = 0; i < seen.size(); ++i)
+        EXPECT_EQ(seen[i], i);
+    EXPECT_TRUE(queue.empty());
+
+    // Nodes can be reused once popped
+    queue.push(&events[3]);
+    EXPECT_EQ(queue.pop(), &events[3]);
+    EXPECT_EQ(queue.pop(), nullptr);
+}
+
+TEST(MPSCQueueTest, ManyProducersOneConsumerKeepPerProducerOrder)
+{
+    constexpr std::uint32_t kProducers = 4;
+    constexpr std::uint64_t kPerProducer = 50'000;
+    quick::structs::MPSCQueue<Event> queue;
+    std::vector<std::vector<Event>> pools(kProducers, std::vector<Event>(kPerProducer));
+
+    std::vector<std::jthread> producers;
+    for (std::uint32_t p = 0; p < kProducers; ++p)
+        producers.emplace_back([&, p] {
+            for (std::uint64_t i = 0; i < kPerProducer; ++i)
+            {
+                Event &e = pools[p][i];
+                e.producer = p;
+                e.seq = i;
+                queue.push(&e);
+            }
+        });
+
+    std::vector<std::uint64_t> next(kProducers, 0);
+    std::uint64_t received = 0;
+    while (received < kProducers * kPerProducer)
+    {
+        const std::size_t n = queue.drain(
+            [&](Event *e) {
+                ASSERT_EQ(e->seq, next[e->producer]) << "producer " << e->producer;
+                ++next[e->producer];
+            },
+            256);
+        received += n;
+        if (n == 0)
+            std::this_thread::yield();
+    }
+    for (std::uint64_t count : next)
+        EXPECT_EQ(count, kPerProducer);
+    EXPECT_TRUE(queue.empty());
+}
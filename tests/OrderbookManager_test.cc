@@ -0,0 +1,118 @@
+// clang-format on
+#include "quick/structs/OrderbookManager.hh"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "quick/utils/XorBitant.hh"
+// clang-format off
+
+using quick::structs::InstrumentId;
+using quick::structs::InstrumentTrade;
+
+TEST(OrderbookManagerTest, RoutesByInstrument)
+{
+    quick::structs::OrderbookManager<LadderOrderbook, 64> manager{3};
+    EXPECT_TRUE(manager.add_instrument(7, Price{0}, Price{1000}, 128U));
+    EXPECT_FALSE(manager.add_instrument(7));
+    EXPECT_TRUE(manager.add_instrument_to_shard(8, 0, Price{0}, Price{1000}, 128U));
+    EXPECT_EQ(manager.shard_of(7), 1);
+    EXPECT_EQ(manager.shard_of(8), 0);
+    EXPECT_EQ(manager.shard_of(9), std::nullopt);
+    EXPECT_FALSE(manager.submit(9, OrderCommand::cancel(1)));
+}
+
+TEST(OrderbookManagerTest, ShardedMatchingEqualsSequentialBooks)
+{
+    constexpr InstrumentId kInstruments = 40;
+    constexpr int kCommands = 40'000;
+
+    quick::structs::OrderbookManager<LadderOrderbook, 1024> manager{4};
+    std::map<InstrumentId, std::unique_ptr<LadderOrderbook>> reference;
+    for (InstrumentId instrument = 0; instrument < kInstruments; ++instrument)
+    {
+        ASSERT_TRUE(manager.add_instrument(instrument, Price{0}, Price{255}, 4096U));
+        reference.emplace(instrument, std::make_unique<LadderOrderbook>(Price{0}, Price{255}, 4096U));
+    }
+
+    XorBitant rng{1234};
+    std::map<InstrumentId, std::vector<Trade>> expected;
+    std::map<InstrumentId, std::vector<Trade>> actual;
+    auto collect = [&](const InstrumentTrade &fill) { actual[fill.instrument].push_back(fill.trade); };
+
+    manager.start();
+    for (int i = 0; i < kCommands; ++i)
+    {
+        const InstrumentId instrument = rng() % kInstruments;
+        const Id id = static_cast<Id>(i + 1);
+        const OrderCommand command =
+            rng() % 4 == 0 ? OrderCommand::cancel(1 + rng() % id)
+                           : OrderCommand::add(Order{id, static_cast<Price>(100 + rng() % 20), (rng() & 1U) != 0,
+                                                     static_cast<Quantity>(1 + rng() % 10)});
+
+        ApplyCommand(*reference[instrument], command,
+                     [&](const Trade &trade) { expected[instrument].push_back(trade); });
+        while (!manager.submit(instrument, command))
+            manager.poll_trades(collect);
+    }
+    manager.stop();
+    manager.poll_trades(collect);
+
+    std::uint64_t processed = 0;
+    for (std::size_t shard = 0; shard < manager.num_shards(); ++shard)
+        processed += manager.processed(shard);
+    EXPECT_EQ(processed, kCommands);
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (auto &[instrument, trades] : expected)
+    {
+        ASSERT_EQ(trades.size(), actual[instrument].size()) << "instrument " << instrument;
+        for (std::size_t i = 0; i < trades.size(); ++i)
+        {
+            EXPECT_EQ(trades[i].OrderIdA, actual[instrument][i].OrderIdA);
+            EXPECT_EQ(trades[i].OrderIdB, actual[instrument][i].OrderIdB);
+            EXPECT_EQ(trades[i].Size, actual[instrument][i].Size);
+            EXPECT_EQ(trades[i].Level, actual[instrument][i].Level);
+        }
+    }
+}
+
+TEST(OrderbookManagerTest, StopKeepsFillsThatOverflowTheQueue)
+{
+    quick::structs::OrderbookManager<LadderOrderbook, 8> manager{1};
+    ASSERT_TRUE(manager.add_instrument(1, Price{0}, Price{255}, 128U));
+
+    // One sweep makes 40 fills against an 8-slot outbound queue that nobody
+    // polls until the manager is stopped
+    constexpr Id kResting = 40;
+    LadderOrderbook reference{Price{0}, Price{255}, 128U};
+    std::vector<Trade> expected;
+    auto route = [&](const OrderCommand &command) {
+        ApplyCommand(reference, command, [&](const Trade &trade) { expected.push_back(trade); });
+        while (!manager.submit(1, command))
+            std::this_thread::yield();
+    };
+
+    manager.start();
+    for (Id id = 1; id <= kResting; ++id)
+        route(OrderCommand::add(Order{id, Price{100}, false, Quantity{1}}));
+    route(OrderCommand::add(Order{kResting + 1, Price{100}, true, Quantity{kResting}}));
+    manager.stop();
+
+    std::vector<Trade> fills;
+    EXPECT_EQ(manager.poll_trades([&](const InstrumentTrade &fill) { fills.push_back(fill.trade); }), kResting);
+    EXPECT_EQ(manager.poll_trades([](const InstrumentTrade &) {}), 0);
+    ASSERT_EQ(expected.size(), kResting);
+    ASSERT_EQ(fills.size(), kResting);
+    for (std::size_t i = 0; i < kResting; ++i)
+    {
+        EXPECT_EQ(fills[i].OrderIdA, expected[i].OrderIdA);
+        EXPECT_EQ(fills[i].OrderIdB, expected[i].OrderIdB);
+        EXPECT_EQ(fills[i].Size, expected[i].Size);
+    }
+}
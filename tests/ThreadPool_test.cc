@@ -4,11 +4,24 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include "quick/structs/SPSCQueue.hh"
+#include "quick/thread/Affinity.hpp"
 #include "quick/utils/Timer.hh"
 #include "test_utils.hh"
 // clang-format off
@@ -27,4 +40,354 @@ TEST_F(ThreadPoolTest, ConstructMultipleThreads) {
   EXPECT_TRUE(tp.get_num_threads() == num_threads) << num_threads;
   TEST_COUT << "num_threads: " << num_threads << std::endl;
   EXPECT_FALSE(tp.get_num_active_tasks());
-}
\ No newline at end of file
+}
+
+TEST_F(ThreadPoolTest, EnqueueReturnsResults) {
+  quick::thread::ThreadPool tp(4);
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 1000; ++i)
+    results.push_back(tp.enqueue([](int a, int b) { return a * b; }, i, 2));
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(results[static_cast<std::size_t>(i)].get(), i * 2);
+
+  auto thrown = tp.enqueue([] { throw std::runtime_error("boom"); });
+  EXPECT_THROW(thrown.get(), std::runtime_error);
+  EXPECT_EQ(tp.get_thread_id(), "-1");
+}
+
+// Every task spawns two children from inside a worker until the tree is
+// deep enough: exercises local pushes, stealing and sleeping/waking
+TEST_F(ThreadPoolTest, NestedTasksRunExactlyOnce) {
+  constexpr int kDepth = 14;
+  std::atomic<int> leaves{0};
+  std::atomic<int> outside_worker{0};
+  {
+    quick::thread::ThreadPool tp(4);
+    std::function<void(int)> spawn = [&](int depth) {
+      if (tp.get_thread_id() == "-1")
+        outside_worker.fetch_add(1);
+      if (depth == 0) {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      tp.enqueue(spawn, depth - 1);
+      tp.enqueue(spawn, depth - 1);
+    };
+    tp.enqueue(spawn, kDepth);
+    while (leaves.load() < (1 << kDepth))
+      std::this_thread::yield();
+  }
+  EXPECT_EQ(leaves.load(), 1 << kDepth);
+  EXPECT_EQ(outside_worker.load(), 0);
+}
+
+TEST_F(ThreadPoolTest, DestructorRunsQueuedTasks) {
+  std::atomic<int> ran{0};
+  {
+    quick::thread::ThreadPool tp(2);
+    // More than the injection queue holds, so submitters also help out
+    for (int i = 0; i < 10'000; ++i)
+      tp.enqueue([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+  }
+  EXPECT_EQ(ran.load(), 10'000);
+}
+
+// A task still running at shutdown may enqueue more and wait for it, while
+// the other workers are already looking for the exit
+TEST_F(ThreadPoolTest, DestructorWaitsForRunningTasks) {
+  std::atomic<int> result{0};
+  {
+    quick::thread::ThreadPool tp(2);
+    tp.post([&] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      result.store(tp.enqueue([] { return 42; }).get());
+    });
+  }
+  EXPECT_EQ(result.load(), 42);
+}
+
+TEST_F(ThreadPoolTest, PostSignalsCompletion) {
+  quick::thread::ThreadPool tp(4);
+  quick::thread::Completion completion;
+  std::atomic<int> ran{0};
+  for (int i = 0; i < 1000; ++i)
+    tp.post(completion, [&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+  completion.wait();
+  EXPECT_TRUE(completion.ready());
+  EXPECT_EQ(ran.load(), 1000);
+
+  // Reusable, and callables too big for a slot are boxed
+  std::array<std::uint64_t, 16> big{};
+  big.fill(3);
+  std::atomic<std::uint64_t> sum{0};
+  tp.post(completion, [big, &sum] {
+    for (auto value : big)
+      sum.fetch_add(value, std::memory_order_relaxed);
+  });
+  completion.wait();
+  EXPECT_EQ(sum.load(), 48U);
+}
+
+// A burst deeper than the slab spills into heap slots instead of blocking
+TEST_F(ThreadPoolTest, PostBurstBeyondSlab) {
+  constexpr int kBurst = 3 * (1 << 12);
+  quick::thread::ThreadPool tp(2);
+  quick::thread::Completion completion;
+  std::atomic<int> ran{0};
+  tp.post(completion, [&] {
+    for (int i = 0; i < kBurst; ++i)
+      tp.post(completion, [&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+  });
+  completion.wait();
+  EXPECT_EQ(ran.load(), kBurst);
+}
+
+TEST_F(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+  quick::thread::ThreadPool tp(4);
+  constexpr std::size_t kCount = 100'003;
+  auto hits = std::make_unique<std::atomic<int>[]>(kCount);
+  for (std::size_t grain : {std::size_t{0}, std::size_t{1}, std::size_t{7}, kCount}) {
+    tp.parallel_for(0, kCount, grain, [&](std::size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+  }
+  for (std::size_t i = 0; i < kCount; ++i)
+    ASSERT_EQ(hits[i].load(), 4) << "index " << i;
+
+  std::vector<int> values(1000, 1);
+  tp.parallel_for(values, 16, [](int &value) { value *= 3; });
+  EXPECT_TRUE(std::ranges::all_of(values, [](int value) { return value == 3; }));
+
+  // Empty range: no tasks, returns at once
+  tp.parallel_for(5, 5, 0, [](std::size_t) { FAIL(); });
+}
+
+TEST_F(ThreadPoolTest, ParallelReduceMatchesSerial) {
+  quick::thread::ThreadPool tp(3);
+  std::vector<std::uint64_t> values(50'000);
+  std::iota(values.begin(), values.end(), std::uint64_t{1});
+
+  const auto sum = tp.parallel_reduce(values, 0, std::uint64_t{0}, std::plus<>{});
+  EXPECT_EQ(sum, std::accumulate(values.begin(), values.end(), std::uint64_t{0}));
+
+  const auto squares = tp.parallel_reduce(values, 100, std::uint64_t{0}, std::plus<>{},
+                                          [](std::uint64_t v) { return v * v; });
+  std::uint64_t expected = 0;
+  for (auto v : values)
+    expected += v * v;
+  EXPECT_EQ(squares, expected);
+
+  // Fixed grain: same chunking, same floating-point result every time
+  std::vector<double> fractions(10'000);
+  for (std::size_t i = 0; i < fractions.size(); ++i)
+    fractions[i] = 1.0 / static_cast<double>(i + 1);
+  const double first = tp.parallel_reduce(fractions, 64, 0.0, std::plus<>{});
+  for (int run = 0; run < 5; ++run)
+    EXPECT_EQ(tp.parallel_reduce(fractions, 64, 0.0, std::plus<>{}), first);
+
+  EXPECT_EQ(tp.parallel_reduce(std::vector<int>{}, 0, 42, std::plus<>{}), 42);
+}
+
+TEST_F(ThreadPoolTest, ParallelTransformAndNesting) {
+  quick::thread::ThreadPool tp(2);
+  std::vector<int> input(10'000);
+  std::iota(input.begin(), input.end(), 0);
+  std::vector<long> output(input.size());
+  tp.parallel_transform(input, output, 0, [](int v) { return 2L * v; });
+  for (std::size_t i = 0; i < input.size(); ++i)
+    ASSERT_EQ(output[i], 2L * input[i]);
+
+  // parallel_for from inside a worker: the worker helps instead of blocking
+  std::atomic<int> inner{0};
+  tp.parallel_for(0, 8, 1, [&](std::size_t) {
+    tp.parallel_for(0, 100, 10, [&](std::size_t) { inner.fetch_add(1, std::memory_order_relaxed); });
+  });
+  EXPECT_EQ(inner.load(), 800);
+}
+
+TEST_F(ThreadPoolTest, ParallelForRethrows) {
+  quick::thread::ThreadPool tp(2);
+  EXPECT_THROW(tp.parallel_for(0, 1000, 10,
+                               [](std::size_t i) {
+                                 if (i == 517)
+                                   throw std::runtime_error("bad index");
+                               }),
+               std::runtime_error);
+  // Still usable afterwards
+  std::atomic<int> ran{0};
+  tp.parallel_for(0, 100, 1, [&](std::size_t) { ran.fetch_add(1); });
+  EXPECT_EQ(ran.load(), 100);
+}
+
+TEST_F(ThreadPoolTest, ParsesCpuLists) {
+  EXPECT_EQ(quick::thread::parse_cpu_list("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  EXPECT_EQ(quick::thread::parse_cpu_list("5"), (std::vector<int>{5}));
+  EXPECT_TRUE(quick::thread::parse_cpu_list("").empty());
+
+  const auto nodes = quick::thread::numa_nodes();
+  ASSERT_FALSE(nodes.empty());
+  EXPECT_FALSE(nodes.front().cpus.empty());
+}
+
+// Placement options on whatever this machine has: pin to the CPUs we are
+// allowed on, group by node, name the threads
+TEST_F(ThreadPoolTest, PinsNamesAndGroupsWorkers) {
+  cpu_set_t allowed;
+  ASSERT_EQ(::sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    if (CPU_ISSET(cpu, &allowed))
+      cpus.push_back(cpu);
+
+  quick::thread::ThreadPoolOptions options;
+  options.num_threads = 3;
+  options.cpus = cpus;
+  options.numa_aware = true;
+  options.name = "pool-with-a-long-name";
+  quick::thread::ThreadPool tp(options);
+  EXPECT_GE(tp.get_num_nodes(), 1U);
+  EXPECT_LE(tp.get_num_nodes(), 3U);
+  for (std::size_t worker = 0; worker < tp.get_num_threads(); ++worker)
+    EXPECT_TRUE(tp.is_pinned(worker)) << "worker " << worker;
+
+  quick::thread::Completion completion;
+  std::atomic<int> misplaced{0};
+  std::atomic<int> misnamed{0};
+  for (int i = 0; i < 64; ++i)
+    tp.post(completion, [&] {
+      if (tp.get_thread_id() == "-1")
+        return; // run by this thread while it helps in wait()
+      // Each worker is pinned to exactly one of our CPUs
+      cpu_set_t set;
+      ::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set);
+      if (CPU_COUNT(&set) != 1)
+        misplaced.fetch_add(1);
+      char name[16]{};
+      ::pthread_getname_np(::pthread_self(), name, sizeof(name));
+      if (std::string_view{name}.substr(0, 8) != "pool-wit" || std::string_view{name}.size() != 15)
+        misnamed.fetch_add(1);
+    });
+  tp.wait(completion);
+  EXPECT_EQ(misplaced.load(), 0);
+  EXPECT_EQ(misnamed.load(), 0);
+}
+
+// A CPU the kernel can't pin to leaves the worker floating, and says so
+TEST_F(ThreadPoolTest, ReportsRefusedPinning) {
+  quick::thread::ThreadPoolOptions options;
+  options.num_threads = 1;
+  options.cpus = {CPU_SETSIZE};
+  quick::thread::ThreadPool tp(options);
+  EXPECT_FALSE(tp.is_pinned(0));
+  EXPECT_EQ(tp.enqueue([] { return 7; }).get(), 7);
+
+  quick::thread::ThreadPool unpinned(1);
+  EXPECT_FALSE(unpinned.is_pinned(0));
+}
+
+namespace {
+// Occupies the single worker of `tp` until `open` is set
+void block_worker(quick::thread::ThreadPool &tp, std::atomic<bool> &started, std::atomic<bool> &open) {
+  tp.post([&] {
+    started.store(true);
+    while (!open.load())
+      std::this_thread::yield();
+  });
+  while (!started.load())
+    std::this_thread::yield();
+}
+
+// One task posting `count` tasks at `priority` into a one-worker pool: nobody
+// else drains the queues it fills
+void post_burst_from_worker(quick::thread::Priority priority, int count) {
+  quick::thread::ThreadPool tp(1);
+  quick::thread::Completion completion;
+  std::atomic<int> ran{0};
+  tp.post(completion, [&] {
+    for (int i = 0; i < count; ++i)
+      tp.post(priority, completion, [&ran] { ran.fetch_add(1, std::memory_order_relaxed); });
+  });
+  completion.wait();
+  EXPECT_EQ(ran.load(), count);
+}
+} // namespace
+
+TEST_F(ThreadPoolTest, UrgentRunsBeforeBackground) {
+  using quick::thread::Priority;
+  quick::thread::ThreadPool tp(1);
+  std::atomic<bool> started{false}, open{false};
+  block_worker(tp, started, open);
+
+  std::vector<Priority> ran;
+  std::mutex ran_mutex;
+  quick::thread::Completion completion;
+  auto record = [&](Priority priority) {
+    return [&, priority] {
+      std::scoped_lock lock(ran_mutex);
+      ran.push_back(priority);
+    };
+  };
+  for (int i = 0; i < 5; ++i)
+    tp.post(Priority::BACKGROUND, completion, record(Priority::BACKGROUND));
+  for (int i = 0; i < 5; ++i)
+    tp.post(Priority::NORMAL, completion, record(Priority::NORMAL));
+  for (int i = 0; i < 5; ++i)
+    tp.post(Priority::URGENT, completion, record(Priority::URGENT));
+
+  EXPECT_EQ(tp.get_queue_depth(Priority::URGENT), 5U);
+  EXPECT_EQ(tp.get_queue_depth(Priority::NORMAL), 5U);
+  EXPECT_EQ(tp.get_queue_depth(Priority::BACKGROUND), 5U);
+  EXPECT_EQ(tp.get_num_active_tasks(), 16U); // and the blocker
+
+  open.store(true);
+  completion.wait();
+  ASSERT_EQ(ran.size(), 15U);
+  // At most one NORMAL turn falls inside the first five dispatches
+  EXPECT_GE(std::ranges::count(ran.begin(), ran.begin() + 6, Priority::URGENT), 5);
+  EXPECT_EQ(ran.back(), Priority::BACKGROUND);
+  for (auto priority : {Priority::URGENT, Priority::NORMAL, Priority::BACKGROUND})
+    EXPECT_EQ(tp.get_queue_depth(priority), 0U);
+
+  auto urgent = tp.enqueue(Priority::URGENT, [](int x) { return x + 1; }, 41);
+  EXPECT_EQ(urgent.get(), 42);
+}
+
+// A stream of urgent work that never lets up still lets background work
+// through on its periodic turn
+TEST_F(ThreadPoolTest, BackgroundWorkIsNotStarved) {
+  using quick::thread::Priority;
+  quick::thread::ThreadPool tp(1);
+  std::atomic<bool> started{false}, open{false};
+  block_worker(tp, started, open);
+
+  std::atomic<bool> background_ran{false};
+  std::atomic<int> urgent_before{0};
+  quick::thread::Completion completion;
+  tp.post(Priority::BACKGROUND, completion, [&] { background_ran.store(true); });
+  // Each urgent task queues the next one until the background task has run
+  std::function<void()> urgent = [&] {
+    if (background_ran.load() || urgent_before.fetch_add(1) > 1000)
+      return;
+    tp.post(Priority::URGENT, completion, urgent);
+  };
+  for (int i = 0; i < 4; ++i)
+    tp.post(Priority::URGENT, completion, urgent);
+
+  open.store(true);
+  completion.wait();
+  EXPECT_TRUE(background_ran.load());
+  EXPECT_LE(urgent_before.load(), static_cast<int>(quick::thread::ThreadPool::kBackgroundEvery));
+}
+
+// Fills the worker's deque and then the injection queue behind it
+TEST_F(ThreadPoolTest, WorkerBurstBeyondQueuesRunsInline) {
+  post_burst_from_worker(quick::thread::Priority::NORMAL, 10'000);
+}
+
+// URGENT and BACKGROUND work from a worker skips its deque: a burst deeper
+// than one injection queue
+TEST_F(ThreadPoolTest, WorkerUrgentBurstBeyondQueue) {
+  post_burst_from_worker(quick::thread::Priority::URGENT, 5'000);
+}
+
+TEST_F(ThreadPoolTest, WorkerBackgroundBurstBeyondQueue) {
+  post_burst_from_worker(quick::thread::Priority::BACKGROUND, 5'000);
+}
@@ -0,0 +1,125 @@
+// clang-format on
+#include "quick/structs/ThreadSafeQueue.hh"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+// clang-format off
+
+using namespace std::chrono_literals;
+
+TEST(ThreadSafeQueueTest, TryOpsAndDrain)
+{
+    quick::structs::ThreadSafeQueue<std::string, 4> queue;
+    std::string out;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.try_pop(out));
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.try_push(std::to_string(i)));
+    EXPECT_FALSE(queue.try_push("full"));
+    EXPECT_EQ(queue.size(), 4U);
+
+    ASSERT_TRUE(queue.try_pop(out));
+    EXPECT_EQ(out, "0");
+
+    std::vector<std::string> rest;
+    EXPECT_EQ(queue.drain_into(rest), 3U);
+    EXPECT_EQ(rest, (std::vector<std::string>{"1", "2", "3"}));
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(ThreadSafeQueueTest, PopForTimesOutThenSucceeds)
+{
+    quick::structs::ThreadSafeQueue<int> queue;
+    int out = 0;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(queue.pop_for(out, 20ms));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 20ms);
+
+    std::jthread producer{[&] {
+        std::this_thread::sleep_for(10ms);
+        queue.push(5);
+    }};
+    ASSERT_TRUE(queue.pop_for(out, 5s));
+    EXPECT_EQ(out, 5);
+}
+
+TEST(ThreadSafeQueueTest, CloseWakesBlockedThreadsAndDrains)
+{
+    quick::structs::ThreadSafeQueue<int, 2> queue;
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+
+    // Blocked on a full queue until close()
+    std::jthread blocked_producer{[&] { EXPECT_FALSE(queue.push(3)); }};
+    std::this_thread::sleep_for(10ms);
+    queue.close();
+    blocked_producer.join();
+
+    EXPECT_FALSE(queue.try_push(4));
+    EXPECT_EQ(queue.wait_and_pop(), 1);
+    EXPECT_FALSE(queue.push(5)) << "closed: refused even with room";
+    EXPECT_EQ(queue.size(), 1U);
+    EXPECT_EQ(queue.wait_and_pop(), 2);
+    EXPECT_EQ(queue.wait_and_pop(), std::nullopt) << "closed and drained: no blocking";
+    int out = 0;
+    EXPECT_FALSE(queue.pop_for(out, 1h));
+}
+
+TEST(ThreadSafeQueueTest, NoDefaultConstructorNeeded)
+{
+    struct Order
+    {
+        explicit Order(int qty) : qty{qty}
+        {
+        }
+        int qty;
+    };
+    quick::structs::ThreadSafeQueue<Order, 4> queue;
+    ASSERT_TRUE(queue.push(Order{1}));
+    ASSERT_TRUE(queue.push(Order{2}));
+    ASSERT_TRUE(queue.push(Order{3}));
+
+    EXPECT_EQ(queue.wait_and_pop()->qty, 1);
+    std::vector<Order> rest;
+    EXPECT_EQ(queue.drain_into(rest), 2U);
+    EXPECT_EQ(rest.back().qty, 3);
+}
+
+TEST(ThreadSafeQueueTest, ManyProducersManyConsumers)
+{
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20'000;
+    quick::structs::ThreadSafeQueue<std::uint64_t, 64> queue;
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<int> received{0};
+
+    std::vector<std::jthread> consumers;
+    for (int c = 0; c < 3; ++c)
+        consumers.emplace_back([&] {
+            while (auto value = queue.wait_and_pop())
+            {
+                sum.fetch_add(*value, std::memory_order_relaxed);
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    {
+        std::vector<std::jthread> producers;
+        for (int p = 0; p < kProducers; ++p)
+            producers.emplace_back([&] {
+                for (std::uint64_t i = 1; i <= kPerProducer; ++i)
+                    ASSERT_TRUE(queue.push(i));
+            });
+    }
+    queue.close();
+    consumers.clear();
+
+    EXPECT_EQ(received.load(), kProducers * kPerProducer);
+    EXPECT_EQ(sum.load(), std::uint64_t{kProducers} * kPerProducer * (kPerProducer + 1) / 2);
+}
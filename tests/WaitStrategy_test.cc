@@ -0,0 +1,69 @@
+// clang-format on
+#include "quick/thread/WaitStrategy.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "quick/structs/MPMCQueue.hh"
+#include "quick/structs/SPSCQueue.hh"
+// clang-format off
+
+template <class Wait> class WaitStrategyTest : public ::testing::Test
+{
+};
+
+using Strategies = ::testing::Types<quick::thread::BusySpinWait, quick::thread::SpinPauseWait,
+                                    quick::thread::SpinYieldWait, quick::thread::SpinBlockWait>;
+TYPED_TEST_SUITE(WaitStrategyTest, Strategies);
+
+// Both sides wait: the consumer while empty, the producer while full
+template <class Queue, class Wait> void run_pipeline(std::uint64_t items)
+{
+    Queue queue;
+    Wait not_empty;
+    Wait not_full;
+
+    std::jthread producer{[&] {
+        for (std::uint64_t i = 0; i < items; ++i)
+        {
+            quick::thread::push_wait(queue, std::uint64_t{i}, not_full);
+            not_empty.notify();
+        }
+    }};
+
+    std::uint64_t value = 0;
+    for (std::uint64_t expected = 0; expected < items; ++expected)
+    {
+        quick::thread::pop_wait(queue, value, not_empty);
+        not_full.notify();
+        ASSERT_EQ(value, expected);
+    }
+}
+
+TYPED_TEST(WaitStrategyTest, DrivesSPSCQueue)
+{
+    run_pipeline<quick::structs::SPSCQueue<std::uint64_t, 256UL>, TypeParam>(20'000);
+}
+
+TYPED_TEST(WaitStrategyTest, DrivesMPMCQueue)
+{
+    run_pipeline<quick::structs::MPMCQueue<std::uint64_t, 256UL>, TypeParam>(20'000);
+}
+
+TEST(SpinBlockWaitTest, SleepsUntilNotified)
+{
+    quick::structs::SPSCQueue<int, 4UL> queue;
+    quick::thread::SpinBlockWait not_empty{0}; // Skip spinning, go straight to the futex
+
+    std::jthread consumer{[&] {
+        int value = 0;
+        quick::thread::pop_wait(queue, value, not_empty);
+        EXPECT_EQ(value, 7);
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    ASSERT_TRUE(queue.push(7));
+    not_empty.notify();
+}
@@ -0,0 +1,80 @@
+// clang-format on
+#include "quick/structs/WorkStealingDeque.hh"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+// clang-format off
+
+TEST(WorkStealingDequeTest, OwnerPopsNewestThievesStealOldest)
+{
+    quick::structs::WorkStealingDeque<int, 4UL> deque;
+    EXPECT_FALSE(deque.pop());
+    EXPECT_FALSE(deque.steal());
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(deque.push(i));
+    EXPECT_FALSE(deque.push(4));
+    EXPECT_EQ(deque.size(), 4);
+
+    EXPECT_EQ(deque.pop(), 3);
+    EXPECT_EQ(deque.steal(), 0);
+    EXPECT_EQ(deque.steal(), 1);
+    EXPECT_EQ(deque.pop(), 2);
+    EXPECT_TRUE(deque.empty());
+
+    // Wraps around the ring once both ends have moved on
+    for (int i = 10; i < 14; ++i)
+        ASSERT_TRUE(deque.push(i));
+    EXPECT_EQ(deque.steal(), 10);
+    EXPECT_EQ(deque.pop(), 13);
+}
+
+TEST(WorkStealingDequeTest, EveryElementTakenExactlyOnce)
+{
+    constexpr std::uint64_t kThieves = 3;
+    constexpr std::uint64_t kTotal = 200'000;
+
+    quick::structs::WorkStealingDeque<std::uint64_t, 256UL> deque;
+    auto seen = std::make_unique<std::atomic<std::uint8_t>[]>(kTotal);
+    std::atomic<std::uint64_t> taken{0};
+    auto take = [&](std::uint64_t value) {
+        seen[value].fetch_add(1, std::memory_order_relaxed);
+        taken.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    {
+        std::vector<std::jthread> thieves;
+        for (std::uint64_t t = 0; t < kThieves; ++t)
+            thieves.emplace_back([&] {
+                while (taken.load(std::memory_order_relaxed) < kTotal)
+                {
+                    if (auto value = deque.steal())
+                        take(*value);
+                    else
+                        std::this_thread::yield();
+                }
+            });
+
+        // Owner: pushes everything, popping every third push so the owner
+        // and thieves fight over the last element often
+        for (std::uint64_t i = 0; i < kTotal; ++i)
+        {
+            while (!deque.push(i))
+                std::this_thread::yield();
+            if (i % 3 == 0)
+                if (auto value = deque.pop())
+                    take(*value);
+        }
+        while (auto value = deque.pop())
+            take(*value);
+    }
+
+    EXPECT_EQ(taken.load(), kTotal);
+    for (std::uint64_t i = 0; i < kTotal; ++i)
+        ASSERT_EQ(seen[i].load(), 1U) << "value " << i;
+}
@@ -3,8 +3,14 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
 
 #include "quick/utils/Timer.hh" 
 #include "test_utils.hh" 
@@ -42,4 +48,149 @@ TEST_F(SPSCQueueTest, AddElements)
 
     // Size shouldn't change
     EXPECT_EQ(p_test_obj.size(), 1024);
-}
\ No newline at end of file
+}
+
+TEST(SPSCQueueThreadedTest, DeliversInOrderAcrossWraparound)
+{
+    // Small ring so both cached indices go stale and get refreshed constantly
+    quick::structs::SPSCQueue<std::uint64_t, 8UL> queue;
+    constexpr std::uint64_t kItems = 200'000;
+
+    std::jthread producer{[&] {
+        for (std::uint64_t i = 0; i < kItems; ++i)
+            while (!queue.push(i))
+                std::this_thread::yield();
+    }};
+
+    std::uint64_t value = 0;
+    for (std::uint64_t expected = 0; expected < kItems; ++expected)
+    {
+        while (!queue.pop(value))
+            std::this_thread::yield();
+        ASSERT_EQ(value, expected);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueBulkTest, PushPopBulkWrapsAround)
+{
+    quick::structs::SPSCQueue<int, 8UL> queue;
+    std::array<int, 6> in{};
+    std::array<int, 8> out{};
+    int next = 0;
+    int expected = 0;
+
+    // Offsets the ring by 6 each round, so copies straddle the end of storage
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int &x : in)
+            x = next++;
+        ASSERT_EQ(queue.push_bulk(in), 6U);
+        ASSERT_EQ(queue.pop_bulk(out), 6U);
+        for (std::size_t i = 0; i < 6; ++i)
+            ASSERT_EQ(out[i], expected++);
+    }
+
+    // Only what fits is pushed
+    std::array<int, 12> big{};
+    EXPECT_EQ(queue.push_bulk(big), 8U);
+    EXPECT_TRUE(queue.full());
+    EXPECT_EQ(queue.push_bulk(big), 0U);
+}
+
+TEST(SPSCQueueBulkTest, TryEmplaceNIsAllOrNothing)
+{
+    quick::structs::SPSCQueue<std::string, 4UL> queue;
+    ASSERT_TRUE(queue.push("a"));
+    EXPECT_FALSE(queue.try_emplace_n(4, [](std::uint64_t i) { return std::to_string(i); }));
+    EXPECT_EQ(queue.size(), 1U);
+
+    ASSERT_TRUE(queue.try_emplace_n(3, [](std::uint64_t i) { return std::to_string(i); }));
+    std::array<std::string, 8> out;
+    ASSERT_EQ(queue.pop_bulk(out), 4U);
+    EXPECT_EQ(out[0], "a");
+    EXPECT_EQ(out[1], "0");
+    EXPECT_EQ(out[3], "2");
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(SPSCQueueZeroCopyTest, ReserveCommitFrontConsume)
+{
+    struct Packet
+    {
+        std::array<char, 256> payload;
+        std::size_t len;
+    };
+    quick::structs::SPSCQueue<Packet, 2UL> queue;
+
+    EXPECT_EQ(queue.front(), nullptr);
+    Packet *slot = queue.reserve();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(queue.reserve(), slot) << "reserve() before commit() hands out the same slot";
+    EXPECT_TRUE(queue.empty()) << "nothing is visible until commit()";
+    slot->len = 3;
+    std::copy_n("abc", 3, slot->payload.begin());
+    queue.commit();
+
+    ASSERT_NE(queue.reserve(), nullptr);
+    queue.commit();
+    EXPECT_EQ(queue.reserve(), nullptr) << "full";
+
+    const Packet *head = queue.front();
+    ASSERT_NE(head, nullptr);
+    EXPECT_EQ(head->len, 3U);
+    EXPECT_EQ(std::string_view(head->payload.data(), head->len), "abc");
+    queue.consume();
+    EXPECT_EQ(queue.size(), 1U);
+    EXPECT_NE(queue.reserve(), nullptr);
+    queue.commit();
+    for (int i = 0; i < 2; ++i)
+    {
+        ASSERT_NE(queue.front(), nullptr);
+        queue.consume();
+    }
+    EXPECT_EQ(queue.front(), nullptr);
+}
+
+TEST(SPSCQueueDynamicTest, RuntimeCapacityRing)
+{
+    using quick::memory::HugePages;
+    for (HugePages pages : {HugePages::NONE, HugePages::TRANSPARENT, HugePages::EXPLICIT})
+    {
+        quick::structs::SPSCQueue<std::string, quick::structs::dynamic_capacity> queue{100, pages};
+        EXPECT_EQ(queue.capacity(), 128U) << "rounded up to a power of two";
+
+        for (int round = 0; round < 3; ++round)
+        {
+            for (int i = 0; i < 128; ++i)
+                ASSERT_TRUE(queue.push(std::to_string(i)));
+            EXPECT_FALSE(queue.push("overflow"));
+            std::string out;
+            for (int i = 0; i < 100; ++i)
+            {
+                ASSERT_TRUE(queue.pop(out));
+                ASSERT_EQ(out, std::to_string(i));
+            }
+            std::array<std::string, 64> rest;
+            ASSERT_EQ(queue.pop_bulk(rest), 28U);
+            EXPECT_EQ(rest[27], "127");
+        }
+        // Left non-empty on purpose: the destructor must clean up
+        ASSERT_TRUE(queue.push("leftover"));
+    }
+}
+
+TEST(SPSCQueueDynamicTest, HugePagesOnlyForBigRings)
+{
+    using Queue = quick::structs::SPSCQueue<double, quick::structs::dynamic_capacity>;
+    constexpr std::uint64_t kHugePageSlots = quick::memory::HugePageRegion::kHugePageSize / sizeof(double);
+
+    // 8 KiB of ring: plain pages, not a 2 MiB THP mapping
+    Queue small_ring{1024};
+    EXPECT_EQ(small_ring.page_backing(), quick::memory::PageBacking::NORMAL);
+    // One huge page: THP requested (the kernel may still refuse it)
+    Queue big_ring{kHugePageSlots};
+    EXPECT_EQ(big_ring.capacity(), kHugePageSlots);
+
+    EXPECT_THROW(Queue{std::uint64_t{1} << 62}, std::length_error);
+}